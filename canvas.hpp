@@ -0,0 +1,876 @@
+#ifndef OLED_CANVAS_H
+#define OLED_CANVAS_H
+
+#include "frameBuffer/Blit.h"
+#include "frameBuffer/FrameBuffer.h"
+#include "frameBuffer/Rle.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace pico_oled {
+
+/// \enum pico_oled::BitmapLayout
+enum class BitmapLayout : uint8_t {
+    /// row after row, ceil(width / 8) bytes each, leftmost pixel in bit 7, same as addBitmapImage takes
+    ROW_MAJOR,
+    /// page after page, width bytes each, every byte holding 8 vertical pixels with the topmost in bit 0,
+    /// same as frame buffer and sprite images
+    PAGE_MAJOR,
+};
+
+/// \brief Entry of the span stack used by Canvas::floodFill: row y is filled from left to right (inclusive) and row
+/// y + dy is still to be checked below or above it
+struct FillSpan {
+    int16_t left;
+    int16_t right;
+    int16_t y;
+    int8_t dy;
+};
+
+/// \class Canvas canvas.hpp "pico-oled/canvas.hpp"
+/// \brief Canvas is anything that can be drawn on: either a display or an off-screen frame buffer.
+///
+/// All renderers take a pointer to a Canvas, so the same drawing code works for displays and off-screen canvases
+class Canvas {
+public:
+    /// how deep viewports and clip rectangles can be nested
+    static constexpr uint8_t MAX_VIEWPORTS = 8;
+
+protected:
+    std::unique_ptr<FrameBuffer> frameBuffer { nullptr };
+    uint8_t width { 128 };
+    uint8_t height { 64 };
+    /// amount of frame buffer rows used by a single canvas row, see ssd1306 readme for 32 px tall displays
+    uint8_t rowScale { 1 };
+
+    /// viewport origin and clip rectangle, all in canvas coordinates, right and bottom edges exclusive
+    struct Viewport {
+        int16_t originX;
+        int16_t originY;
+        int16_t left;
+        int16_t top;
+        int16_t right;
+        int16_t bottom;
+    };
+
+    Viewport viewport { 0, 0, 0, 0, 128, 64 };
+    Viewport viewportStack[MAX_VIEWPORTS] {};
+    uint8_t viewportDepth { 0 };
+
+    /// Constructor for displays, which create frame buffer on their own and call resetViewports once size is known
+    Canvas() = default;
+
+    /// \brief Changes pixel at canvas coordinates, ignoring viewport. Coordinates have to be inside canvas
+    inline void plot(const int16_t x, const int16_t y, const WriteMode mode)
+    {
+        // canvas with doubled rows sets two neighbouring bits of the buffer for a single pixel
+        // remember that buffer is a one dimension array, so we have to calculate offset from coordinates
+        const auto row = static_cast<uint8_t>(y * rowScale);
+        const auto byte = static_cast<uint8_t>(((1U << rowScale) - 1) << (row & 7));
+        const size_t n = x + (row >> 3) * frameBuffer->GetWidth();
+
+        // check the write mode and manipulate the frame buffer
+        if (mode == WriteMode::ADD || mode == WriteMode::COPY) {
+            this->frameBuffer->byteOR(n, byte);
+        } else if (mode == WriteMode::SUBTRACT) {
+            this->frameBuffer->byteAND(n, ~byte);
+        } else if (mode == WriteMode::INVERT) {
+            this->frameBuffer->byteXOR(n, byte);
+        }
+    }
+
+    /// \brief Moves rectangle from viewport to canvas coordinates and clips it
+    /// \return false if nothing of the rectangle is left
+    inline bool clipRect(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const
+    {
+        // worked out in 32 bits, so rectangles near the ends of int16_t range don't wrap around
+        const int32_t left = std::max<int32_t>(x + viewport.originX, viewport.left);
+        const int32_t top = std::max<int32_t>(y + viewport.originY, viewport.top);
+        const int32_t right = std::min<int32_t>(x + viewport.originX + w, viewport.right);
+        const int32_t bottom = std::min<int32_t>(y + viewport.originY + h, viewport.bottom);
+        if (right <= left || bottom <= top)
+            return false;
+        x = left;
+        y = top;
+        w = right - left;
+        h = bottom - top;
+        return true;
+    }
+
+    /// applies write mode to a rectangle given in viewport coordinates
+    inline void fillClipped(int16_t x, int16_t y, int16_t w, int16_t h, const WriteMode mode)
+    {
+        if (!clipRect(x, y, w, h))
+            return;
+        this->frameBuffer->fillRegion(x, y * rowScale, w, h * rowScale, mode);
+    }
+
+    /// \brief Visible part of a sloped line, worked out by clipLine
+    struct LineWalk {
+        /// first visible pixel in canvas coordinates
+        int16_t x;
+        int16_t y;
+        /// amount of visible pixels after the first one
+        int16_t steps;
+        /// Bresenham error term at the first visible pixel
+        int32_t error;
+        /// absolute length of the line along its major and minor axis
+        int32_t major;
+        int32_t minor;
+        /// minor axis direction, 1 or -1
+        int8_t step;
+        bool xMajor;
+    };
+
+    /// \brief Clips a sloped line given in canvas coordinates against the viewport.
+    ///
+    /// Lines are walked with integer Bresenham, from the left end for x major lines and from the top end for y major
+    /// ones, so every line covers the same pixels no matter the order of its ends. After k major steps the minor
+    /// axis moved n(k) = (2 k minor + major - bias) / (2 major) pixels, bias being 1 for y major lines which step on
+    /// a positive error only. Like Liang-Barsky the viewport edges are turned into a range of k, inverting n(k) for the
+    /// minor axis, and the error term at the first visible pixel is computed from n(k) directly, so clipped lines
+    /// cost nothing for their invisible pixels
+    /// \return false if no pixel of the line is visible
+    inline bool clipLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, LineWalk& walk) const
+    {
+        walk.xMajor = std::abs(y1 - y0) <= std::abs(x1 - x0);
+        if (walk.xMajor ? x0 > x1 : y0 > y1) {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+        }
+        const int32_t a0 = walk.xMajor ? x0 : y0;
+        const int32_t b0 = walk.xMajor ? y0 : x0;
+        const int32_t b1 = walk.xMajor ? y1 : x1;
+        const int32_t aLow = walk.xMajor ? viewport.left : viewport.top;
+        const int32_t aHigh = (walk.xMajor ? viewport.right : viewport.bottom) - 1;
+        const int32_t bLow = walk.xMajor ? viewport.top : viewport.left;
+        const int32_t bHigh = (walk.xMajor ? viewport.bottom : viewport.right) - 1;
+        walk.major = (walk.xMajor ? x1 : y1) - a0;
+        walk.minor = std::abs(b1 - b0);
+        walk.step = b1 > b0 ? 1 : -1;
+        const int64_t bias = walk.xMajor ? 0 : 1;
+        const int64_t twiceMajor = 2 * static_cast<int64_t>(walk.major);
+        const int64_t twiceMinor = 2 * static_cast<int64_t>(walk.minor);
+
+        int32_t first = std::max<int32_t>(0, aLow - a0);
+        int32_t last = std::min<int32_t>(walk.major, aHigh - a0);
+        // visible range of n, which never decreases along the line
+        const int32_t nLow = walk.step > 0 ? bLow - b0 : b0 - bHigh;
+        const int32_t nHigh = walk.step > 0 ? bHigh - b0 : b0 - bLow;
+        if (nHigh < 0 || nLow > walk.minor)
+            return false;
+        // n(k) >= nLow from k = ceil(((2 nLow - 1) major + bias) / (2 minor)) on
+        if (nLow > 0)
+            first = std::max<int32_t>(first, ((2 * nLow - 1) * static_cast<int64_t>(walk.major) + bias + twiceMinor - 1) / twiceMinor);
+        // n(k) <= nHigh up to k = ceil(((2 nHigh + 1) major + bias) / (2 minor)) - 1
+        if (nHigh < walk.minor)
+            last = std::min<int32_t>(last, ((2 * nHigh + 1) * static_cast<int64_t>(walk.major) + bias + twiceMinor - 1) / twiceMinor - 1);
+        if (first > last)
+            return false;
+
+        const int64_t n = (first * twiceMinor + walk.major - bias) / twiceMajor;
+        walk.error = static_cast<int32_t>((first + 1) * twiceMinor - walk.major - n * twiceMajor);
+        walk.steps = static_cast<int16_t>(last - first);
+        const int32_t a = a0 + first;
+        const int32_t b = b0 + walk.step * static_cast<int32_t>(n);
+        walk.x = static_cast<int16_t>(walk.xMajor ? a : b);
+        walk.y = static_cast<int16_t>(walk.xMajor ? b : a);
+        return true;
+    }
+
+    /// \brief Calls visit(x, y) for every pixel of a clipped line
+    template <typename Visit>
+    static inline void walkLine(LineWalk walk, Visit visit)
+    {
+        int16_t& major = walk.xMajor ? walk.x : walk.y;
+        int16_t& minor = walk.xMajor ? walk.y : walk.x;
+        // x major lines step minor axis on zero error too
+        const int32_t threshold = walk.xMajor ? -1 : 0;
+        for (int16_t i = 0;; i++) {
+            visit(walk.x, walk.y);
+            if (i == walk.steps)
+                break;
+            major++;
+            if (walk.error > threshold) {
+                minor += walk.step;
+                walk.error -= 2 * walk.major;
+            }
+            walk.error += 2 * walk.minor;
+        }
+    }
+
+    /// \brief Draws a clipped line, covering the same pixels as walkLine.
+    /// Buffer position and bit mask are stepped along with the line instead of being computed for every pixel, and
+    /// pixels of steep lines sharing a byte are written at once
+    template <typename Op>
+    inline void lineBytes(const LineWalk& walk, Op op)
+    {
+        const uint8_t stride = this->frameBuffer->GetWidth();
+        uint8_t* p = this->frameBuffer->get() + walk.x + (walk.y >> 3) * stride;
+        uint8_t bit = 1 << (walk.y & 7);
+        int32_t error = walk.error;
+
+        if (walk.xMajor) {
+            const bool down = walk.step > 0;
+            for (int16_t i = 0;; i++) {
+                *p = op(*p, bit);
+                if (i == walk.steps)
+                    break;
+                p++;
+                if (error < 0) {
+                    error += 2 * walk.minor;
+                    continue;
+                }
+                error += 2 * (walk.minor - walk.major);
+                if (down) {
+                    bit <<= 1;
+                    if (bit == 0) {
+                        bit = 0x01;
+                        p += stride;
+                    }
+                } else {
+                    bit >>= 1;
+                    if (bit == 0) {
+                        bit = 0x80;
+                        p -= stride;
+                    }
+                }
+            }
+        } else {
+            uint8_t pending = 0;
+            for (int16_t i = 0;; i++) {
+                pending |= bit;
+                if (i == walk.steps)
+                    break;
+                bit <<= 1;
+                const bool stepped = error > 0;
+                error += stepped ? 2 * (walk.minor - walk.major) : 2 * walk.minor;
+                // bits of one byte are collected and written together
+                if (stepped || bit == 0) {
+                    *p = op(*p, pending);
+                    pending = 0;
+                    if (bit == 0) {
+                        bit = 0x01;
+                        p += stride;
+                    }
+                    p += stepped ? walk.step : 0;
+                }
+            }
+            *p = op(*p, pending);
+        }
+    }
+
+    /// draws run length encoded sprite page by page, see addSprite
+    inline void addRleSprite(const int16_t anchorX, const int16_t anchorY, const uint8_t* sprite, const WriteMode mode)
+    {
+        const uint8_t spriteWidth = sprite[0];
+        const uint8_t spriteHeight = sprite[1];
+        const bool masked = sprite[2] & 0x01;
+        RleDecoder decoder(sprite + 3);
+        uint8_t image[255], mask[255];
+
+        for (int16_t top = 0; top < spriteHeight; top += 8) {
+            const int16_t rows = std::min<int16_t>(8, spriteHeight - top);
+            const bool visible = this->isVisible(anchorX, anchorY + top, spriteWidth, rows);
+            // pages below the viewport don't need to be decoded at all
+            if (!visible && anchorY + top + viewport.originY >= viewport.bottom)
+                return;
+            if (!visible) {
+                decoder.skip(masked ? 2 * spriteWidth : spriteWidth);
+                continue;
+            }
+            decoder.read(image, spriteWidth);
+            if (masked)
+                decoder.read(mask, spriteWidth);
+            this->drawPages(anchorX, anchorY + top, image, masked ? mask : nullptr, spriteWidth, rows, 0, 0, spriteWidth, rows, mode);
+        }
+    }
+
+    /// draws block of raw page-major pixels clipped to the viewport, see blitPages
+    inline void drawPages(int16_t dx, int16_t dy, const uint8_t* src, const uint8_t* mask, const uint8_t srcWidth, const uint8_t srcHeight,
+        int16_t sx, int16_t sy, int16_t w, int16_t h, const WriteMode mode)
+    {
+        // clip destination, moving the source corner along
+        const int16_t x = dx, y = dy;
+        if (!clipRect(dx, dy, w, h))
+            return;
+        sx += dx - viewport.originX - x;
+        sy += dy - viewport.originY - y;
+
+        if (rowScale == 1) {
+            blitPages(this->frameBuffer->get(), this->frameBuffer->GetWidth(), this->frameBuffer->GetHeight(), dx, dy,
+                src, mask, srcWidth, srcHeight, sx, sy, w, h, mode);
+            return;
+        }
+
+        // doubled rows can't be shifted into place, so go pixel by pixel
+        for (int16_t row = 0; row < h; row++) {
+            for (int16_t col = 0; col < w; col++) {
+                const int16_t srcX = sx + col, srcY = sy + row;
+                if (srcX < 0 || srcY < 0 || srcX >= srcWidth || srcY >= srcHeight)
+                    continue;
+                const size_t n = srcX + (srcY >> 3) * srcWidth;
+                if (mask && !((mask[n] >> (srcY & 7)) & 1))
+                    continue;
+                if ((src[n] >> (srcY & 7)) & 1) {
+                    this->plot(dx + col, dy + row, mode);
+                } else if (mode == WriteMode::COPY) {
+                    this->plot(dx + col, dy + row, WriteMode::SUBTRACT);
+                }
+            }
+        }
+    }
+
+public:
+    /// \brief Creates an off-screen canvas with its own frame buffer
+    /// \param width, height - canvas size in pixels
+    /// \param bufferWidth - bytes per page of the frame buffer if it has to be wider than the canvas, ex. to match display buffer
+    /// \param rowScale - frame buffer rows per canvas row, only needed to match 32 px tall SSD1306 displays
+    explicit Canvas(const uint8_t width, const uint8_t height, const uint8_t bufferWidth = 0, const uint8_t rowScale = 1)
+        : frameBuffer(std::make_unique<FrameBuffer>(std::max(width, bufferWidth), static_cast<uint8_t>(height * rowScale)))
+        , width(width)
+        , height(height)
+        , rowScale(rowScale)
+    {
+        this->resetViewports();
+    }
+
+    Canvas(Canvas&&) = default;
+    Canvas& operator=(Canvas&&) = default;
+    virtual ~Canvas() = default;
+
+    inline uint8_t GetWidth() const { return width; }
+
+    inline uint8_t GetHeight() const { return height; }
+
+    /// Returns frame buffer the canvas draws into
+    inline FrameBuffer& GetFrameBuffer() { return *frameBuffer; }
+
+    /// Returns frame buffer the canvas draws into
+    inline const FrameBuffer& GetFrameBuffer() const { return *frameBuffer; }
+
+    /// \brief Set pixel operates frame buffer
+    /// x is the x position of pixel you want to change. values 0 - 127
+    /// y is the y position of pixel you want to change. values 0 - 31 or 0 - 63
+    /// \param x - position of pixel you want to change. values 0 - 127, others are ignored
+    /// \param y - position of pixel you want to change. values 0 - 31 or 0 - 63, others are ignored
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    virtual void setPixel(const int16_t x, const int16_t y, const WriteMode mode = WriteMode::ADD)
+    {
+        const int32_t canvasX = x + viewport.originX;
+        const int32_t canvasY = y + viewport.originY;
+
+        // return if position outside of clip rectangle
+        if (canvasX < viewport.left || canvasX >= viewport.right || canvasY < viewport.top || canvasY >= viewport.bottom)
+            return;
+
+        this->plot(canvasX, canvasY, mode);
+    }
+
+    /// \brief Pushes a viewport: drawing is moved by x, y and limited to w x h pixels from there, within the current viewport.
+    ///
+    /// Clipping is done once per span, glyph or image rather than for every pixel, so it's cheap to draw into a
+    /// viewport even if most of the content ends up outside, ex. in scrolling lists
+    /// \param x, y - top left corner of new viewport, relative to the current one
+    /// \param w, h - size of new viewport
+    /// \return false if viewport stack is full, nothing is changed then
+    inline bool pushViewport(const int16_t x, const int16_t y, const int16_t w, const int16_t h)
+    {
+        if (!this->pushClip(x, y, w, h))
+            return false;
+        viewport.originX += x;
+        viewport.originY += y;
+        return true;
+    }
+
+    /// \brief Pushes a clip rectangle: drawing is limited to w x h pixels from x, y, within the current viewport.
+    /// Unlike pushViewport coordinates are not moved
+    /// \return false if viewport stack is full, nothing is changed then
+    inline bool pushClip(int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+        if (viewportDepth >= MAX_VIEWPORTS)
+            return false;
+        viewportStack[viewportDepth++] = viewport;
+        if (!clipRect(x, y, w, h))
+            w = h = 0;
+        viewport.left = x;
+        viewport.top = y;
+        viewport.right = x + w;
+        viewport.bottom = y + h;
+        return true;
+    }
+
+    /// \brief Restores viewport or clip rectangle that was active before the last push
+    inline void popViewport()
+    {
+        if (viewportDepth > 0)
+            viewport = viewportStack[--viewportDepth];
+    }
+
+    /// \brief Drops all pushed viewports, so the whole canvas can be drawn on again
+    inline void resetViewports()
+    {
+        viewportDepth = 0;
+        viewport = { 0, 0, 0, 0, width, height };
+    }
+
+    /// \brief Returns clip rectangle of the current viewport in its own coordinates, ex. to skip invisible rows of a shape
+    /// \param left, top - first visible column and row
+    /// \param right, bottom - first column and row past the visible ones
+    inline void GetClipRect(int16_t& left, int16_t& top, int16_t& right, int16_t& bottom) const
+    {
+        left = viewport.left - viewport.originX;
+        top = viewport.top - viewport.originY;
+        right = viewport.right - viewport.originX;
+        bottom = viewport.bottom - viewport.originY;
+    }
+
+    /// \brief Checks if any part of a rectangle would be drawn in the current viewport, ex. to skip whole glyphs
+    inline bool isVisible(int16_t x, int16_t y, int16_t w, int16_t h) const
+    {
+        return clipRect(x, y, w, h);
+    }
+
+    /// \brief Adds bitmap image to frame buffer
+    ///
+    /// Image is row-major, each row starting at a new byte with leftmost pixel in bit 7. Visible part of the image is
+    /// worked out once, then every 8x8 block is transposed into display memory layout and shifted into place whole
+    /// \param anchorX - sets start point of where to put the image on the screen
+    /// \param anchorY - sets start point of where to put the image on the screen
+    /// \param image_width - width of the image in pixels
+    /// \param image_height - height of the image in pixels
+    /// \param image - pointer to uint8_t (unsigned char) array containing image data
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    inline void addBitmapImage(const int16_t anchorX, const int16_t anchorY, const uint8_t image_width, const uint8_t image_height, const uint8_t* image, const WriteMode mode = WriteMode::ADD)
+    {
+        const int16_t rowBytes = (image_width + 7) >> 3;
+        const int16_t x = anchorX + viewport.originX;
+        const int16_t y = anchorY + viewport.originY;
+
+        // part of the image that ends up inside the viewport
+        const int16_t xStart = std::max<int16_t>(0, viewport.left - x);
+        const int16_t xEnd = std::min<int16_t>(image_width, viewport.right - x);
+        const int16_t yStart = std::max<int16_t>(0, viewport.top - y);
+        const int16_t yEnd = std::min<int16_t>(image_height, viewport.bottom - y);
+        if (xStart >= xEnd || yStart >= yEnd)
+            return;
+
+        if (rowScale != 1) {
+            // doubled rows can't be shifted into place, so go pixel by pixel
+            for (int16_t row = yStart; row < yEnd; row++) {
+                for (int16_t col = xStart; col < xEnd; col++) {
+                    if ((image[row * rowBytes + (col >> 3)] >> (7 - (col & 7))) & 1) {
+                        this->plot(x + col, y + row, mode);
+                    } else if (mode == WriteMode::COPY) {
+                        this->plot(x + col, y + row, WriteMode::SUBTRACT);
+                    }
+                }
+            }
+            return;
+        }
+
+        // every 8 rows of image are transposed into a page tall strip, up to 16 blocks at a time
+        constexpr int16_t stripBlocks = 16;
+        uint8_t strip[stripBlocks * 8];
+        uint8_t rows[8];
+        const int16_t firstBlock = xStart >> 3;
+        const int16_t lastBlock = (xEnd - 1) >> 3;
+        for (int16_t blockY = yStart & ~7; blockY < yEnd; blockY += 8) {
+            const int16_t rowStart = std::max(blockY, yStart);
+            const int16_t rowEnd = std::min<int16_t>(blockY + 8, yEnd);
+            for (int16_t chunk = firstBlock; chunk <= lastBlock; chunk += stripBlocks) {
+                const int16_t chunkEnd = std::min<int16_t>(chunk + stripBlocks - 1, lastBlock);
+                for (int16_t block = chunk; block <= chunkEnd; block++) {
+                    for (int16_t r = 0; r < 8; r++) {
+                        rows[r] = blockY + r < image_height ? image[(blockY + r) * rowBytes + block] : 0;
+                    }
+                    transpose8x8(rows, strip + (block - chunk) * 8);
+                }
+                const int16_t colStart = std::max<int16_t>(chunk * 8, xStart);
+                const int16_t colEnd = std::min<int16_t>((chunkEnd + 1) * 8, xEnd);
+                blitPages(this->frameBuffer->get(), this->frameBuffer->GetWidth(), this->frameBuffer->GetHeight(),
+                    x + colStart, y + rowStart, strip, nullptr, static_cast<uint8_t>((chunkEnd - chunk + 1) * 8), 8,
+                    colStart - chunk * 8, rowStart - blockY, colEnd - colStart, rowEnd - rowStart, mode);
+            }
+        }
+    }
+
+    /// \brief Applies write mode to a whole rectangular region of canvas at once.
+    /// Way more efficient than calling setPixel for every pixel of the region
+    /// \param x, y - top left corner of the region
+    /// \param w, h - width and height of the region in pixels
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    inline void fillRegion(const int16_t x, const int16_t y, const int16_t w, const int16_t h, const WriteMode mode = WriteMode::ADD)
+    {
+        this->fillClipped(x, y, w, h, mode);
+    }
+
+    /// \brief Applies write mode to the pixels of a rectangular region that are set in an 8x8 pattern, ex. to grey
+    /// out a disabled widget. As frame buffer is page-major, this costs the same as a solid fill
+    ///
+    /// Pattern is aligned to the canvas rather than to the region, so neighbouring fills line up
+    /// \param x, y - top left corner of the region
+    /// \param w, h - width and height of the region in pixels
+    /// \param pattern - 8 bytes, byte x & 7 holding column x with row y & 7 in bit y & 7, ex. PATTERN_50. nullptr fills solid
+    /// \param mode - ADD sets pattern pixels, SUBTRACT clears them, INVERT inverts them and COPY replaces the region with the pattern
+    inline void fillRegion(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* pattern, const WriteMode mode = WriteMode::ADD)
+    {
+        if (pattern == nullptr) {
+            this->fillClipped(x, y, w, h, mode);
+            return;
+        }
+        if (!clipRect(x, y, w, h))
+            return;
+
+        if (rowScale != 1) {
+            // doubled rows don't match pattern bits, so go pixel by pixel
+            for (int16_t row = y; row < y + h; row++) {
+                for (int16_t col = x; col < x + w; col++) {
+                    if ((pattern[col & 7] >> (row & 7)) & 1) {
+                        this->plot(col, row, mode);
+                    } else if (mode == WriteMode::COPY) {
+                        this->plot(col, row, WriteMode::SUBTRACT);
+                    }
+                }
+            }
+            return;
+        }
+        this->frameBuffer->fillRegion(x, y, w, h, pattern, mode);
+    }
+
+    /// \brief Applies write mode to a horizontal line of pixels. Way faster than setPixel for every pixel of it
+    /// \param x0, x1 - first and last column of the line, in any order
+    /// \param y - row of the line
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    inline void hspan(const int16_t x0, const int16_t x1, const int16_t y, const WriteMode mode = WriteMode::ADD)
+    {
+        // clipped before the width is computed, which doesn't fit int16_t for far apart ends
+        const int32_t left = std::max<int32_t>(std::min(x0, x1), viewport.left - viewport.originX);
+        const int32_t right = std::min<int32_t>(std::max(x0, x1), viewport.right - viewport.originX - 1);
+        if (left <= right)
+            this->fillClipped(left, y, right - left + 1, 1, mode);
+    }
+
+    /// \brief Applies write mode to a vertical line of pixels. Way faster than setPixel for every pixel of it
+    /// \param x - column of the line
+    /// \param y0, y1 - first and last row of the line, in any order
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    inline void vspan(const int16_t x, const int16_t y0, const int16_t y1, const WriteMode mode = WriteMode::ADD)
+    {
+        const int32_t top = std::max<int32_t>(std::min(y0, y1), viewport.top - viewport.originY);
+        const int32_t bottom = std::min<int32_t>(std::max(y0, y1), viewport.bottom - viewport.originY - 1);
+        if (top <= bottom)
+            this->fillClipped(x, top, 1, bottom - top + 1, mode);
+    }
+
+    /// \brief Applies write mode to a line of pixels from x0, y0 to x1, y1, both ends included.
+    ///
+    /// Horizontal and vertical lines are spans. Sloped ones are clipped against the viewport first, see clipLine, then
+    /// integer Bresenham writes the visible part straight into frame buffer bytes
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    inline void line(const int16_t x0, const int16_t y0, const int16_t x1, const int16_t y1, const WriteMode mode = WriteMode::ADD)
+    {
+        if (y0 == y1) {
+            this->hspan(x0, x1, y0, mode);
+            return;
+        }
+        if (x0 == x1) {
+            this->vspan(x0, y0, y1, mode);
+            return;
+        }
+
+        LineWalk walk;
+        if (!this->clipLine(x0 + viewport.originX, y0 + viewport.originY, x1 + viewport.originX, y1 + viewport.originY, walk))
+            return;
+
+        if (rowScale != 1) {
+            walkLine(walk, [&](int16_t x, int16_t y) { this->plot(x, y, mode); });
+            return;
+        }
+
+        switch (mode) {
+        case WriteMode::ADD:
+        case WriteMode::COPY:
+            this->lineBytes(walk, [](uint8_t d, uint8_t m) { return static_cast<uint8_t>(d | m); });
+            break;
+        case WriteMode::SUBTRACT:
+            this->lineBytes(walk, [](uint8_t d, uint8_t m) { return static_cast<uint8_t>(d & ~m); });
+            break;
+        case WriteMode::INVERT:
+            this->lineBytes(walk, [](uint8_t d, uint8_t m) { return static_cast<uint8_t>(d ^ m); });
+            break;
+        }
+    }
+
+    /// \brief Sets all pixels of a rectangular region off. See fillRegion
+    inline void clearRegion(const int16_t x, const int16_t y, const int16_t w, const int16_t h)
+    {
+        this->fillRegion(x, y, w, h, WriteMode::SUBTRACT);
+    }
+
+    /// \brief Inverts all pixels of a rectangular region, ex. for highlighting a menu entry. See fillRegion
+    inline void invertRegion(const int16_t x, const int16_t y, const int16_t w, const int16_t h)
+    {
+        this->fillRegion(x, y, w, h, WriteMode::INVERT);
+    }
+
+    /// \brief Fills the area of same coloured pixels around x, y, ex. a user drawn shape or a region of a map outline.
+    ///
+    /// Scanline seed fill: rows are read straight from the frame buffer, every run of pixels is filled as a single
+    /// span and spans whose neighbouring rows are still to be checked are kept on a caller provided stack, so there
+    /// is no recursion and memory use is fixed. Area is 4-connected and limited to the clip rectangle of the viewport.
+    /// If the stack runs out, spans that don't fit are dropped and the area is left partially filled, the rest of it
+    /// staying as it was. A simple shape needs a few entries, areas with many notches or holes about one per notch
+    /// \param x, y - seed pixel, area is made of pixels of its colour
+    /// \param stack - storage for pending spans
+    /// \param capacity - amount of entries in stack
+    /// \param mode - ADD fills a dark area, SUBTRACT clears a lit one and INVERT inverts the area whatever its colour.
+    /// COPY works like ADD
+    /// \return false if the stack ran out and part of the area is left unfilled
+    inline bool floodFill(const int16_t x, const int16_t y, FillSpan* stack, const uint16_t capacity, const WriteMode mode = WriteMode::ADD)
+    {
+        const int16_t seedX = x + viewport.originX;
+        const int16_t seedY = y + viewport.originY;
+        if (seedX < viewport.left || seedY < viewport.top || seedX >= viewport.right || seedY >= viewport.bottom)
+            return true;
+
+        const uint8_t* buffer = this->frameBuffer->get();
+        const uint8_t bufferWidth = this->frameBuffer->GetWidth();
+        const auto isLit = [&](const int16_t col, const int16_t row) {
+            const auto bufferRow = static_cast<uint8_t>(row * rowScale);
+            return ((buffer[col + (bufferRow >> 3) * bufferWidth] >> (bufferRow & 7)) & 1) != 0;
+        };
+
+        // every pixel of the area gets the same new colour, which has to differ from the old one, so filled pixels
+        // are never picked up again
+        const bool target = isLit(seedX, seedY);
+        const bool lit = mode == WriteMode::INVERT ? !target : mode != WriteMode::SUBTRACT;
+        if (lit == target)
+            return true;
+        const WriteMode fillMode = lit ? WriteMode::ADD : WriteMode::SUBTRACT;
+
+        uint16_t depth = 0;
+        bool complete = true;
+        const auto push = [&](const int16_t left, const int16_t right, const int16_t row, const int8_t dy) {
+            if (row + dy < viewport.top || row + dy >= viewport.bottom)
+                return;
+            if (depth == capacity) {
+                complete = false;
+                return;
+            }
+            stack[depth++] = { left, right, row, dy };
+        };
+
+        // seed row is checked as if the row below it was filled, the row below is checked afterwards
+        push(seedX, seedX, seedY + 1, -1);
+        push(seedX, seedX, seedY, 1);
+        while (depth > 0) {
+            const FillSpan span = stack[--depth];
+            const int16_t row = span.y + span.dy;
+            int16_t col = span.left;
+            while (col <= span.right) {
+                if (isLit(col, row) != target) {
+                    col++;
+                    continue;
+                }
+                // run touching the left end of the span can reach past it, others start right after a border pixel
+                int16_t start = col;
+                if (start == span.left) {
+                    while (start > viewport.left && isLit(start - 1, row) == target)
+                        start--;
+                }
+                int16_t end = col;
+                while (end + 1 < viewport.right && isLit(end + 1, row) == target)
+                    end++;
+                this->frameBuffer->fillRegion(start, row * rowScale, end - start + 1, rowScale, fillMode);
+
+                push(start, end, row, span.dy);
+                // parts of the run past the span have unchecked pixels on the row it came from
+                if (start < span.left)
+                    push(start, span.left - 1, row, -span.dy);
+                if (end > span.right)
+                    push(span.right + 1, end, row, -span.dy);
+                col = end + 2;
+            }
+        }
+        return complete;
+    }
+
+    /// \brief Fills the area around x, y using a stack array, see floodFill
+    template <size_t N>
+    inline bool floodFill(const int16_t x, const int16_t y, FillSpan (&stack)[N], const WriteMode mode = WriteMode::ADD)
+    {
+        return this->floodFill(x, y, stack, static_cast<uint16_t>(std::min<size_t>(N, UINT16_MAX)), mode);
+    }
+
+    /// \brief Moves content of a rectangular region by dx, dy pixels and fills the exposed area. See FrameBuffer::scrollRegion
+    /// \param x, y - top left corner of the region, limited to the viewport
+    /// \param w, h - size of the region
+    /// \param dx, dy - distance to move the content by, positive values move it right and down
+    /// \param fill - display memory byte to fill exposed area with, 0x00 for dark, 0xFF for lit pixels or any pattern
+    inline void scrollRegion(int16_t x, int16_t y, int16_t w, int16_t h, const int16_t dx, const int16_t dy, const uint8_t fill = 0x00)
+    {
+        if (!this->clipRect(x, y, w, h))
+            return;
+        this->frameBuffer->scrollRegion(x, y * rowScale, w, h * rowScale, dx, dy * rowScale, fill);
+    }
+
+    /// \brief Draws a rectangular block of pixels from another frame buffer, ex. an off-screen icon sheet.
+    /// Whole bytes are shifted into place, so it's way faster than addBitmapImage.
+    /// src can be the canvas' own frame buffer, ex. to move a block on screen, in which case source and destination
+    /// may overlap. That's not the case for 32 px tall SSD1306 displays, whose doubled rows are copied pixel by pixel
+    /// \param dx, dy - where to put top left corner of the block on the screen
+    /// \param src - frame buffer to take pixels from
+    /// \param sx, sy - top left corner of the block in src
+    /// \param w, h - size of the block in pixels
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    inline void blit(const int16_t dx, const int16_t dy, const FrameBuffer& src, const int16_t sx, const int16_t sy, const int16_t w, const int16_t h, const WriteMode mode = WriteMode::COPY)
+    {
+        this->drawPages(dx, dy, src.get(), nullptr, src.GetWidth(), src.GetHeight(), sx, sy, w, h, mode);
+    }
+
+    /// \brief Adds page-major sprite to frame buffer
+    ///
+    /// Sprite data is laid out the same way as display memory, so whole bytes get copied instead of single pixels.
+    /// The array starts with width, height and flags bytes, followed by width * ceil(height / 8) bytes of image
+    /// and, when bit 0 of flags is set, the same amount of mask bytes. Only pixels set in mask get drawn.
+    /// When bit 1 of flags is set the data is run length encoded, see RleDecoder, with every image page followed by
+    /// its mask page. Such sprites are decoded one page at a time straight into the frame buffer.
+    /// Use tools/sprite_convert.py or pico_oled_add_sprites() in CMake to create sprites from PBM or PNG files
+    /// \param anchorX - sets start point of where to put the sprite on the screen
+    /// \param anchorY - sets start point of where to put the sprite on the screen
+    /// \param sprite - pointer to sprite data
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    inline void addSprite(const int16_t anchorX, const int16_t anchorY, const uint8_t* sprite, const WriteMode mode = WriteMode::ADD)
+    {
+        const uint8_t spriteWidth = sprite[0];
+        const uint8_t spriteHeight = sprite[1];
+        if (sprite[2] & 0x02) {
+            this->addRleSprite(anchorX, anchorY, sprite, mode);
+            return;
+        }
+        const uint8_t* image = sprite + 3;
+        const uint8_t* mask = (sprite[2] & 0x01) ? image + spriteWidth * ((spriteHeight + 7) >> 3) : nullptr;
+        this->drawPages(anchorX, anchorY, image, mask, spriteWidth, spriteHeight, 0, 0, spriteWidth, spriteHeight, mode);
+    }
+
+    /// \brief Returns state of a pixel, ex. for collision tests. Coordinates are moved by the viewport origin like
+    /// for drawing, but the clip rectangle doesn't apply
+    /// \return true if pixel is lit, false if not or if it's outside of canvas
+    inline bool getPixel(const int16_t x, const int16_t y) const
+    {
+        const int16_t canvasX = x + viewport.originX;
+        const int16_t canvasY = y + viewport.originY;
+        if (canvasX < 0 || canvasY < 0 || canvasX >= width || canvasY >= height)
+            return false;
+        const auto row = static_cast<uint8_t>(canvasY * rowScale);
+        return (this->frameBuffer->get()[canvasX + (row >> 3) * this->frameBuffer->GetWidth()] >> (row & 7)) & 1;
+    }
+
+    /// \brief Copies a rectangle of pixels into a bitmap, ex. to save what's under a popup or to export a screenshot.
+    ///
+    /// Page-major bitmaps are a block transfer out of the frame buffer, row-major ones are additionally transposed
+    /// 8x8 pixels at a time. Coordinates are moved by the viewport origin like for drawing, pixels outside of canvas read as 0
+    /// \param x, y - top left corner of the rectangle
+    /// \param w, h - size of the rectangle
+    /// \param out - bitmap of size h * ceil(w / 8) bytes for ROW_MAJOR or w * ceil(h / 8) bytes for PAGE_MAJOR
+    /// \param layout - memory layout of out, see BitmapLayout. Row-major bitmap can be drawn back with addBitmapImage,
+    /// page-major one with blit or as sprite image
+    inline void readRegion(const int16_t x, const int16_t y, const uint8_t w, const uint8_t h, uint8_t* out, const BitmapLayout layout = BitmapLayout::ROW_MAJOR) const
+    {
+        const int16_t canvasX = x + viewport.originX;
+        const int16_t canvasY = y + viewport.originY;
+        const uint8_t pages = (h + 7) >> 3;
+        const uint8_t rowBytes = (w + 7) >> 3;
+
+        if (rowScale != 1) {
+            // doubled rows can't be read as blocks, so go pixel by pixel
+            memset(out, 0, layout == BitmapLayout::ROW_MAJOR ? h * rowBytes : w * pages);
+            for (uint8_t row = 0; row < h; row++) {
+                for (uint8_t col = 0; col < w; col++) {
+                    if (!this->getPixel(x + col, y + row))
+                        continue;
+                    if (layout == BitmapLayout::ROW_MAJOR) {
+                        out[row * rowBytes + (col >> 3)] |= 0x80 >> (col & 7);
+                    } else {
+                        out[col + (row >> 3) * w] |= 1 << (row & 7);
+                    }
+                }
+            }
+            return;
+        }
+
+        // only the part inside canvas is transferred, frame buffer might be wider than canvas
+        const int16_t readWidth = std::min<int16_t>(w, width - canvasX);
+        const FrameBuffer& source = *this->frameBuffer;
+
+        if (layout == BitmapLayout::PAGE_MAJOR) {
+            memset(out, 0, w * pages);
+            blitPages(out, w, h, 0, 0, source.get(), nullptr, source.GetWidth(), height, canvasX, canvasY, readWidth, h);
+            return;
+        }
+
+        // every 8 rows are first gathered as a page-major strip, then turned into rows block by block
+        uint8_t strip[256];
+        for (uint8_t page = 0; page < pages; page++) {
+            const uint8_t rows = std::min<uint8_t>(8, h - page * 8);
+            memset(strip, 0, sizeof(strip));
+            blitPages(strip, w, rows, 0, 0, source.get(), nullptr, source.GetWidth(), height, canvasX, canvasY + page * 8, readWidth, rows);
+
+            for (uint8_t block = 0; block < rowBytes; block++) {
+                // reversing both ends of the transpose turns columns back into rows
+                uint8_t columns[8], bits[8];
+                for (uint8_t i = 0; i < 8; i++)
+                    columns[i] = strip[block * 8 + 7 - i];
+                transpose8x8(columns, bits);
+                for (uint8_t row = 0; row < rows; row++)
+                    out[(page * 8 + row) * rowBytes + block] = bits[7 - row];
+            }
+        }
+    }
+
+    /// \brief Manually set frame buffer by copying it. make sure it's the same size as GetFrameBuffer().GetBufferSize(),
+    /// that is 1024 bytes for SSD1306 and 1056 bytes for SH1106
+    /// \param buffer - pointer to a new buffer
+    inline void setBuffer(const uint8_t* buffer, const size_t bufferSz)
+    {
+        if (bufferSz != this->frameBuffer->GetBufferSize()) return;
+        this->frameBuffer->setBuffer(buffer, bufferSz);
+    }
+
+    /// \brief Draws into caller owned storage from now on, ex. a static array or an arena, instead of copying anything.
+    /// Storage has to be GetFrameBuffer().GetBufferSize() bytes and outlive the canvas or the next setBuffer call.
+    /// Its content is shown as it is, clear it if needed
+    /// \param buffer - pointer to the storage
+    inline void setBuffer(uint8_t* buffer)
+    {
+        this->frameBuffer->setBuffer(buffer);
+    }
+
+    /// \brief Makes canvas use frame buffer of another one, so whatever is drawn on either of them shows on both.
+    /// Useful for mirroring one screen to several identical displays: draw once, then call sendBuffer of each.
+    /// Other canvas has to outlive this one
+    /// \return false if canvases differ in size or memory layout, ex. SSD1306 and SH1106
+    inline bool shareBuffer(Canvas& other)
+    {
+        const FrameBuffer& otherBuffer = other.GetFrameBuffer();
+        if (otherBuffer.GetWidth() != this->frameBuffer->GetWidth() || otherBuffer.GetHeight() != this->frameBuffer->GetHeight()
+            || other.width != width || other.height != height || other.rowScale != rowScale)
+            return false;
+        this->frameBuffer->setBuffer(other.frameBuffer->get());
+        return true;
+    }
+
+    /// \brief Clears canvas aka set all bytes to 0
+    inline void clear()
+    {
+        this->frameBuffer->clear();
+    }
+
+};
+
+}
+
+#endif // OLED_CANVAS_H
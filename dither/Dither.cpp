@@ -0,0 +1,153 @@
+#include "Dither.h"
+
+namespace {
+
+constexpr uint8_t BAYER4[4][4] = {
+    { 0, 8, 2, 10 },
+    { 12, 4, 14, 6 },
+    { 3, 11, 1, 9 },
+    { 15, 7, 13, 5 },
+};
+
+constexpr uint8_t BAYER8[8][8] = {
+    { 0, 32, 8, 40, 2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44, 4, 36, 14, 46, 6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    { 3, 35, 11, 43, 1, 33, 9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47, 7, 39, 13, 45, 5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 },
+};
+
+// error rows have 2 extra values on both sides, so neighbours of edge pixels need no checks
+constexpr uint8_t ERROR_MARGIN = 2;
+
+}
+
+namespace pico_oled {
+
+Ditherer::Ditherer(Canvas* canvas, int16_t anchorX, int16_t anchorY, uint8_t width, DitherMethod method, uint8_t threshold)
+    : canvas(canvas)
+    , anchorX(anchorX)
+    , anchorY(anchorY)
+    , width(width)
+    , method(method)
+    , threshold(threshold)
+    , strip(width, 8)
+{
+    if (method == DitherMethod::FLOYD_STEINBERG || method == DitherMethod::ATKINSON) {
+        this->errors = std::make_unique<int16_t[]>(3 * (width + 2 * ERROR_MARGIN));
+    }
+}
+
+Ditherer::~Ditherer()
+{
+    this->finish();
+}
+
+void Ditherer::flushStrip()
+{
+    if (row == 0)
+        return;
+    this->canvas->blit(anchorX, anchorY, this->strip, 0, 0, width, row, WriteMode::COPY);
+    this->strip.clear();
+    anchorY += row;
+    row = 0;
+}
+
+void Ditherer::finish()
+{
+    this->flushStrip();
+}
+
+void Ditherer::pushRow(const uint8_t* pixels)
+{
+    uint8_t* out = this->strip.get();
+    const uint8_t bit = 1 << row;
+
+    switch (method) {
+    case DitherMethod::THRESHOLD:
+        for (uint8_t x = 0; x < width; x++) {
+            if (pixels[x] >= threshold)
+                out[x] |= bit;
+        }
+        break;
+
+    case DitherMethod::BAYER4: {
+        // pattern follows canvas position, so neighbouring images line up
+        const uint8_t* matrix = BAYER4[(anchorY + row) & 3];
+        for (uint8_t x = 0; x < width; x++) {
+            if (pixels[x] >= matrix[(anchorX + x) & 3] * 16 + 8)
+                out[x] |= bit;
+        }
+        break;
+    }
+
+    case DitherMethod::BAYER8: {
+        const uint8_t* matrix = BAYER8[(anchorY + row) & 7];
+        for (uint8_t x = 0; x < width; x++) {
+            if (pixels[x] >= matrix[(anchorX + x) & 7] * 4 + 2)
+                out[x] |= bit;
+        }
+        break;
+    }
+
+    case DitherMethod::FLOYD_STEINBERG:
+    case DitherMethod::ATKINSON: {
+        const size_t stride = width + 2 * ERROR_MARGIN;
+        // error rows are used round robin, so none of them has to be moved
+        int16_t* current = this->errors.get() + ERROR_MARGIN + errorRow * stride;
+        int16_t* next = this->errors.get() + ERROR_MARGIN + ((errorRow + 1) % 3) * stride;
+        int16_t* after = this->errors.get() + ERROR_MARGIN + ((errorRow + 2) % 3) * stride;
+        const bool atkinson = method == DitherMethod::ATKINSON;
+
+        for (uint8_t x = 0; x < width; x++) {
+            const int16_t value = pixels[x] + current[x];
+            int16_t error = value;
+            if (value >= threshold) {
+                out[x] |= bit;
+                error = value - 255;
+            }
+
+            if (atkinson) {
+                // 1/8 to six neighbours, the remaining 2/8 are dropped
+                error /= 8;
+                current[x + 1] += error;
+                current[x + 2] += error;
+                next[x - 1] += error;
+                next[x] += error;
+                next[x + 1] += error;
+                after[x] += error;
+            } else {
+                // last neighbour takes what rounding left over, so no error gets lost
+                const int16_t right = error * 7 / 16;
+                const int16_t belowLeft = error * 3 / 16;
+                const int16_t below = error * 5 / 16;
+                current[x + 1] += right;
+                next[x - 1] += belowLeft;
+                next[x] += below;
+                next[x + 1] += error - right - belowLeft - below;
+            }
+        }
+
+        // row that was just used becomes the empty one two rows below
+        memset(current - ERROR_MARGIN, 0, stride * sizeof(int16_t));
+        errorRow = (errorRow + 1) % 3;
+        break;
+    }
+    }
+
+    if (++row == 8)
+        this->flushStrip();
+}
+
+void drawGrayImage(Canvas* canvas, int16_t anchorX, int16_t anchorY, uint8_t width, uint8_t height, const uint8_t* pixels, DitherMethod method)
+{
+    Ditherer ditherer(canvas, anchorX, anchorY, width, method);
+    for (uint8_t y = 0; y < height; y++) {
+        ditherer.pushRow(pixels + y * width);
+    }
+}
+
+}
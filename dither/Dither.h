@@ -0,0 +1,79 @@
+#ifndef OLED_DITHER_H
+#define OLED_DITHER_H
+
+#include "../canvas.hpp"
+
+namespace pico_oled {
+
+/// \enum pico_oled::DitherMethod
+enum class DitherMethod : uint8_t {
+    /// pixels at or above threshold are lit, fastest but loses all shading
+    THRESHOLD,
+    /// ordered dithering with 4x4 Bayer matrix, 17 levels in a regular cross hatch
+    BAYER4,
+    /// ordered dithering with 8x8 Bayer matrix, 65 levels in a finer cross hatch
+    BAYER8,
+    /// Floyd-Steinberg error diffusion, smoothest gradients
+    FLOYD_STEINBERG,
+    /// Atkinson error diffusion, spreads only 3/4 of the error so contrast stays higher, good for photos on small panels
+    ATKINSON,
+};
+
+/// \class Ditherer Dither.h "pico-oled/dither/Dither.h"
+/// \brief Turns 8 bit grayscale rows into lit and dark pixels of a canvas, one row at a time.
+///
+/// Rows don't have to be kept after pushRow returns, so images can be read from a camera or a sensor line by line
+/// without ever holding the whole grayscale picture. Dithered pixels are collected straight into a page-major strip of
+/// 8 rows, which is copied to the canvas as a block whenever it fills up.
+/// Error diffusion keeps error of the current and the next two rows, that is 3 * (width + 4) 16 bit values.
+class Ditherer {
+    Canvas* canvas;
+    int16_t anchorX;
+    int16_t anchorY;
+    uint8_t width;
+    DitherMethod method;
+    uint8_t threshold;
+    uint8_t row { 0 };
+    uint8_t errorRow { 0 };
+    FrameBuffer strip;
+    std::unique_ptr<int16_t[]> errors { nullptr };
+
+    /// copies rows collected in the strip to the canvas
+    void flushStrip();
+
+public:
+    /// \brief Starts a dithered image on canvas
+    /// \param canvas - pointer to a Canvas object, either an initialised display or an off-screen canvas
+    /// \param anchorX, anchorY - where to put top left corner of the image
+    /// \param width - amount of pixels in every row
+    /// \param method - dithering method, see DitherMethod
+    /// \param threshold - gray value from which a pixel is lit, used by THRESHOLD and error diffusion
+    Ditherer(Canvas* canvas, int16_t anchorX, int16_t anchorY, uint8_t width, DitherMethod method = DitherMethod::FLOYD_STEINBERG, uint8_t threshold = 128);
+
+    /// Draws rows that are still waiting in the strip
+    ~Ditherer();
+
+    Ditherer(const Ditherer&) = delete;
+    Ditherer& operator=(const Ditherer&) = delete;
+
+    /// \brief Dithers next row of the image
+    /// \param pixels - width gray values, 0 being black and 255 white, that is lit
+    void pushRow(const uint8_t* pixels);
+
+    /// \brief Draws rows that are still waiting in the strip, call it when the image is complete.
+    /// Rows pushed after it continue below the image
+    void finish();
+};
+
+/// \brief Draws an 8 bit grayscale image dithered to lit and dark pixels. See Ditherer
+/// \param canvas - pointer to a Canvas object, either an initialised display or an off-screen canvas
+/// \param anchorX, anchorY - where to put top left corner of the image
+/// \param width, height - size of the image
+/// \param pixels - width * height gray values row after row, 0 being black and 255 white
+/// \param method - dithering method, see DitherMethod
+void drawGrayImage(Canvas* canvas, int16_t anchorX, int16_t anchorY, uint8_t width, uint8_t height, const uint8_t* pixels,
+    DitherMethod method = DitherMethod::FLOYD_STEINBERG);
+
+}
+
+#endif // OLED_DITHER_H
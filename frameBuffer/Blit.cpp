@@ -0,0 +1,177 @@
+#include "Blit.h"
+
+#include <algorithm>
+
+namespace {
+
+// returns 8 source rows starting `shift` bits into the lo page, hi being the page right below
+// missing pages (outside of the source) read as empty
+inline uint8_t gather(const uint8_t* lo, const uint8_t* hi, int i, uint8_t shift)
+{
+    const uint16_t pair = (lo ? lo[i] : 0) | ((hi ? hi[i] : 0) << 8);
+    return static_cast<uint8_t>(pair >> shift);
+}
+
+// backwards walks the row right to left, so a source to the left of the destination on the same page is read before
+// it's overwritten
+template <typename Op>
+void blitRow(uint8_t* d, const uint8_t* lo, const uint8_t* hi, const uint8_t* maskLo, const uint8_t* maskHi,
+    bool masked, uint8_t shift, uint8_t rowMask, int w, bool backwards, Op op)
+{
+    for (int k = 0; k < w; k++) {
+        const int i = backwards ? w - 1 - k : k;
+        uint8_t m = rowMask;
+        if (masked)
+            m &= gather(maskLo, maskHi, i, shift);
+        d[i] = static_cast<uint8_t>(op(d[i], gather(lo, hi, i, shift), m));
+    }
+}
+
+}
+
+namespace pico_oled {
+
+void blitPages(uint8_t* dst, uint8_t dstWidth, uint8_t dstHeight, int16_t dx, int16_t dy,
+    const uint8_t* src, const uint8_t* mask, uint8_t srcWidth, uint8_t srcHeight,
+    int16_t sx, int16_t sy, int16_t w, int16_t h, WriteMode mode)
+{
+    int x0 = dx, y0 = dy, srcX = sx, srcY = sy, width = w, height = h;
+
+    // clip against source
+    if (srcX < 0) {
+        x0 -= srcX;
+        width += srcX;
+        srcX = 0;
+    }
+    if (srcY < 0) {
+        y0 -= srcY;
+        height += srcY;
+        srcY = 0;
+    }
+    width = std::min(width, srcWidth - srcX);
+    height = std::min(height, srcHeight - srcY);
+
+    // clip against destination
+    if (x0 < 0) {
+        srcX -= x0;
+        width += x0;
+        x0 = 0;
+    }
+    if (y0 < 0) {
+        srcY -= y0;
+        height += y0;
+        y0 = 0;
+    }
+    width = std::min(width, dstWidth - x0);
+    height = std::min(height, dstHeight - y0);
+
+    if (width <= 0 || height <= 0)
+        return;
+
+    const int yEnd = y0 + height - 1;
+    const int srcPages = (srcHeight + 7) >> 3;
+
+    auto page = [&](const uint8_t* base, int p) -> const uint8_t* {
+        if (base == nullptr || p < 0 || p >= srcPages)
+            return nullptr;
+        return base + p * srcWidth + srcX;
+    };
+
+    // block moved within the same array is walked away from where it moves to, so every source byte is read before
+    // it's overwritten: bottom up when moving down, as a destination page only reads the pages above it and itself,
+    // and right to left when moving right
+    const bool same = src == dst;
+    const bool upwards = same && srcY < y0;
+    const bool backwards = same && srcX < x0;
+    const int firstPage = y0 >> 3;
+    const int lastPage = yEnd >> 3;
+
+    for (int k = firstPage; k <= lastPage; k++) {
+        const int dp = upwards ? firstPage + lastPage - k : k;
+        uint8_t rowMask = 0xFF;
+        if (dp == y0 >> 3)
+            rowMask &= static_cast<uint8_t>(0xFF << (y0 & 7));
+        if (dp == yEnd >> 3)
+            rowMask &= static_cast<uint8_t>(0xFF >> (7 - (yEnd & 7)));
+
+        // source row landing on bit 0 of this destination page, might be above the source for the first page
+        const int srcRow = srcY + dp * 8 - y0;
+        const int sp = srcRow >= 0 ? srcRow >> 3 : -((7 - srcRow) >> 3);
+        const auto shift = static_cast<uint8_t>(srcRow - sp * 8);
+
+        uint8_t* d = dst + dp * dstWidth + x0;
+        const uint8_t* lo = page(src, sp);
+        const uint8_t* hi = page(src, sp + 1);
+        const uint8_t* maskLo = page(mask, sp);
+        const uint8_t* maskHi = page(mask, sp + 1);
+        const bool masked = mask != nullptr;
+
+        switch (mode) {
+        case WriteMode::ADD:
+            blitRow(d, lo, hi, maskLo, maskHi, masked, shift, rowMask, width, backwards,
+                [](uint8_t dv, uint8_t sv, uint8_t m) { return dv | (sv & m); });
+            break;
+        case WriteMode::SUBTRACT:
+            blitRow(d, lo, hi, maskLo, maskHi, masked, shift, rowMask, width, backwards,
+                [](uint8_t dv, uint8_t sv, uint8_t m) { return dv & ~(sv & m); });
+            break;
+        case WriteMode::INVERT:
+            blitRow(d, lo, hi, maskLo, maskHi, masked, shift, rowMask, width, backwards,
+                [](uint8_t dv, uint8_t sv, uint8_t m) { return dv ^ (sv & m); });
+            break;
+        case WriteMode::COPY:
+            blitRow(d, lo, hi, maskLo, maskHi, masked, shift, rowMask, width, backwards,
+                [](uint8_t dv, uint8_t sv, uint8_t m) { return (dv & ~m) | (sv & m); });
+            break;
+        }
+    }
+}
+
+void transpose8x8(const uint8_t* rows, uint8_t* columns)
+{
+    // rows are packed bottom first, so the topmost row ends up in bit 0 of every column
+    uint32_t x = (static_cast<uint32_t>(rows[7]) << 24) | (rows[6] << 16) | (rows[5] << 8) | rows[4];
+    uint32_t y = (static_cast<uint32_t>(rows[3]) << 24) | (rows[2] << 16) | (rows[1] << 8) | rows[0];
+    uint32_t t;
+
+    // swap bits across the diagonal of 2x2, then 4x4, then 8x8 blocks
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    columns[0] = static_cast<uint8_t>(x >> 24);
+    columns[1] = static_cast<uint8_t>(x >> 16);
+    columns[2] = static_cast<uint8_t>(x >> 8);
+    columns[3] = static_cast<uint8_t>(x);
+    columns[4] = static_cast<uint8_t>(y >> 24);
+    columns[5] = static_cast<uint8_t>(y >> 16);
+    columns[6] = static_cast<uint8_t>(y >> 8);
+    columns[7] = static_cast<uint8_t>(y);
+}
+
+void blit(FrameBuffer& dst, int16_t dx, int16_t dy, const FrameBuffer& src, int16_t sx, int16_t sy, int16_t w, int16_t h, WriteMode mode)
+{
+    blitPages(dst.get(), dst.GetWidth(), dst.GetHeight(), dx, dy,
+        src.get(), nullptr, src.GetWidth(), src.GetHeight(), sx, sy, w, h, mode);
+}
+
+void blitMasked(FrameBuffer& dst, int16_t dx, int16_t dy, const FrameBuffer& src, const FrameBuffer& mask, int16_t sx, int16_t sy, int16_t w, int16_t h)
+{
+    // mask has to line up with source byte for byte
+    if (mask.GetWidth() != src.GetWidth() || mask.GetHeight() < src.GetHeight())
+        return;
+    blitPages(dst.get(), dst.GetWidth(), dst.GetHeight(), dx, dy,
+        src.get(), mask.get(), src.GetWidth(), src.GetHeight(), sx, sy, w, h, WriteMode::COPY);
+}
+
+}
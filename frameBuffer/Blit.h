@@ -0,0 +1,50 @@
+#ifndef OLED_BLIT_H
+#define OLED_BLIT_H
+
+#include "FrameBuffer.h"
+
+namespace pico_oled {
+
+/// \brief Transfers a rectangular block of pixels between raw page-major arrays
+///
+/// Source rows are gathered at any bit offset by merging two neighbouring source pages and shifting them into
+/// place, so a destination byte takes one operation no matter how source and destination are aligned.
+/// The block is clipped against both arrays once before any pixel is touched.
+/// When src and dst are the same array, ex. to move a block within a frame buffer, source and destination regions
+/// may overlap: the block is walked in the direction that reads every source byte before it's overwritten.
+/// \param dst - destination page-major array, dstWidth bytes per page
+/// \param dstWidth, dstHeight - size of destination in pixels
+/// \param dx, dy - where to put top left corner of the block in destination
+/// \param src - source page-major array, srcWidth bytes per page
+/// \param mask - optional page-major array of the same geometry as src, only pixels with mask bit set are transferred.
+/// nullptr transfers all of them
+/// \param srcWidth, srcHeight - size of source in pixels
+/// \param sx, sy - top left corner of the block in source
+/// \param w, h - size of the block in pixels
+/// \param mode - COPY replaces destination pixels, other modes combine set source pixels with destination. See WriteMode doc
+void blitPages(uint8_t* dst, uint8_t dstWidth, uint8_t dstHeight, int16_t dx, int16_t dy,
+    const uint8_t* src, const uint8_t* mask, uint8_t srcWidth, uint8_t srcHeight,
+    int16_t sx, int16_t sy, int16_t w, int16_t h, WriteMode mode = WriteMode::COPY);
+
+/// \brief Transposes an 8x8 pixel block from row-major to page-major layout with shifts and masks, no loop over bits
+/// \param rows - 8 bytes, one per pixel row, leftmost pixel in bit 7 as in bitmap images
+/// \param columns - 8 output bytes, one per pixel column, topmost pixel in bit 0 as in display memory
+void transpose8x8(const uint8_t* rows, uint8_t* columns);
+
+/// \brief Transfers a rectangular block of pixels from one frame buffer to another. See blitPages
+/// \param dst - frame buffer to draw into
+/// \param dx, dy - where to put top left corner of the block in dst
+/// \param src - frame buffer to take pixels from
+/// \param sx, sy - top left corner of the block in src
+/// \param w, h - size of the block in pixels
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void blit(FrameBuffer& dst, int16_t dx, int16_t dy, const FrameBuffer& src, int16_t sx, int16_t sy, int16_t w, int16_t h, WriteMode mode = WriteMode::COPY);
+
+/// \brief Copies a rectangular block of pixels from one frame buffer to another, but only where mask has pixels set.
+/// Useful for drawing sprites with transparent areas. See blitPages
+/// \param mask - frame buffer of the same geometry as src, selecting which pixels are copied
+void blitMasked(FrameBuffer& dst, int16_t dx, int16_t dy, const FrameBuffer& src, const FrameBuffer& mask, int16_t sx, int16_t sy, int16_t w, int16_t h);
+
+}
+
+#endif // OLED_BLIT_H
@@ -1,9 +1,130 @@
 #include "FrameBuffer.h"
+#include "Rle.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// word type allowed to alias the byte buffer
+typedef uint32_t __attribute__((__may_alias__)) word_t;
+
+// applies op to n consecutive bytes of dst, 4 bytes at a time wherever dst and src share word alignment
+// op gets destination, source and mask, and is called with either bytes or words
+template <typename Op>
+void applyRun(uint8_t* dst, const uint8_t* src, size_t n, uint8_t mask, Op op)
+{
+    if (((reinterpret_cast<uintptr_t>(dst) ^ reinterpret_cast<uintptr_t>(src)) & 3) == 0) {
+        // unaligned column edge on the left
+        while (n && (reinterpret_cast<uintptr_t>(dst) & 3)) {
+            *dst = static_cast<uint8_t>(op(*dst, *src, mask));
+            dst++;
+            src++;
+            n--;
+        }
+        // mask byte replicated into every byte of the word
+        const uint32_t wordMask = mask * 0x01010101U;
+        for (; n >= 4; n -= 4, dst += 4, src += 4) {
+            *reinterpret_cast<word_t*>(dst) = op(*reinterpret_cast<word_t*>(dst), *reinterpret_cast<const word_t*>(src), wordMask);
+        }
+    }
+    // unaligned column edge on the right, or whole run if alignment differs
+    while (n--) {
+        *dst = static_cast<uint8_t>(op(*dst, *src, mask));
+        dst++;
+        src++;
+    }
+}
+
+// clips region against buffer geometry and calls applyRun for every covered page row
+// src is expected to have the same geometry as dst, or be nullptr when op does not need it
+template <typename Op>
+void regionOp(uint8_t* dst, const uint8_t* src, uint8_t stride, uint8_t height,
+    uint8_t x, uint8_t y, uint8_t w, uint8_t h, Op op)
+{
+    if (w == 0 || h == 0 || x >= stride || y >= height)
+        return;
+
+    // exclusive end of the region
+    const uint16_t xEnd = std::min<uint16_t>(x + w, stride);
+    const uint16_t yEnd = std::min<uint16_t>(y + h, height);
+    const size_t len = xEnd - x;
+    const uint8_t firstPage = y >> 3;
+    const uint8_t lastPage = (yEnd - 1) >> 3;
+
+    auto pageMask = [&](uint8_t page) {
+        uint8_t mask = 0xFF;
+        if (page == firstPage)
+            mask &= static_cast<uint8_t>(0xFF << (y & 7));
+        if (page == lastPage)
+            mask &= static_cast<uint8_t>(0xFF >> (7 - ((yEnd - 1) & 7)));
+        return mask;
+    };
+
+    uint8_t page = firstPage;
+    while (page <= lastPage) {
+        const uint8_t mask = pageMask(page);
+        uint8_t pages = 1;
+        // full width pages are contiguous in memory, so they are done as a single run
+        if (mask == 0xFF && len == stride) {
+            while (page + pages <= lastPage && pageMask(page + pages) == 0xFF)
+                pages++;
+        }
+        const size_t offset = page * stride + x;
+        applyRun(dst + offset, src ? src + offset : dst + offset, len * pages, mask, op);
+        page += pages;
+    }
+}
+
+// mask of rows first to last (inclusive) falling into page
+inline uint8_t rowMask(int first, int last, int page)
+{
+    const int top = std::max(first, page * 8);
+    const int bottom = std::min(last, page * 8 + 7);
+    if (top > bottom)
+        return 0;
+    return static_cast<uint8_t>((0xFF << (top & 7)) & (0xFF >> (7 - (bottom & 7))));
+}
+
+}
+
+void pico_oled::combineBytes(uint8_t* dst, const uint8_t* src, size_t n, WriteMode mode)
+{
+    if (mode == WriteMode::ADD) {
+        applyRun(dst, src, n, 0xFF, [](auto d, auto s, auto) { return d | s; });
+    } else if (mode == WriteMode::SUBTRACT) {
+        applyRun(dst, src, n, 0xFF, [](auto d, auto s, auto) { return d & ~s; });
+    } else if (mode == WriteMode::INVERT) {
+        applyRun(dst, src, n, 0xFF, [](auto d, auto s, auto) { return d ^ s; });
+    } else if (mode == WriteMode::COPY) {
+        memcpy(dst, src, n);
+    }
+}
 
 FrameBuffer::FrameBuffer(const size_t buffSz)
     : bufferSize(buffSz)
+    , width(128)
+    , height(static_cast<uint8_t>(buffSz / 128 * 8))
+{
+    this->owned = std::make_unique<uint8_t[]>(bufferSize);
+    this->buffer = this->owned.get();
+}
+
+FrameBuffer::FrameBuffer(const uint8_t width, const uint8_t height)
+    : bufferSize(static_cast<size_t>(width) * ((height + 7) >> 3))
+    , width(width)
+    , height(height)
+{
+    this->owned = std::make_unique<uint8_t[]>(bufferSize);
+    this->buffer = this->owned.get();
+}
+
+FrameBuffer::FrameBuffer(uint8_t* storage, const uint8_t width, const uint8_t height)
+    : bufferSize(static_cast<size_t>(width) * ((height + 7) >> 3))
+    , width(width)
+    , height(height)
+    , buffer(storage)
 {
-    this->buffer = std::make_unique<uint8_t[]>(bufferSize);
 }
 
 void FrameBuffer::byteOR(size_t n, uint8_t byte)
@@ -30,18 +151,196 @@ void FrameBuffer::byteXOR(size_t n, uint8_t byte)
     this->buffer[n] ^= byte;
 }
 
+void FrameBuffer::fillRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h, pico_oled::WriteMode mode)
+{
+    if (mode == pico_oled::WriteMode::ADD || mode == pico_oled::WriteMode::COPY) {
+        regionOp(buffer, nullptr, width, height, x, y, w, h,
+            [](auto d, auto, auto m) { return d | m; });
+    } else if (mode == pico_oled::WriteMode::SUBTRACT) {
+        regionOp(buffer, nullptr, width, height, x, y, w, h,
+            [](auto d, auto, auto m) { return d & ~m; });
+    } else if (mode == pico_oled::WriteMode::INVERT) {
+        regionOp(buffer, nullptr, width, height, x, y, w, h,
+            [](auto d, auto, auto m) { return d ^ m; });
+    }
+}
+
+void FrameBuffer::fillRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t* pattern, pico_oled::WriteMode mode)
+{
+    if (pattern == nullptr) {
+        fillRegion(x, y, w, h, mode);
+        return;
+    }
+    if (w == 0 || h == 0 || x >= width || y >= height)
+        return;
+
+    const uint16_t xEnd = std::min<uint16_t>(x + w, width);
+    const uint16_t yEnd = std::min<uint16_t>(y + h, height);
+    auto apply = [&](auto op) {
+        for (int page = y >> 3; page <= (yEnd - 1) >> 3; page++) {
+            // pattern columns limited to rows of the region
+            const uint8_t mask = rowMask(y, yEnd - 1, page);
+            uint8_t masked[8];
+            for (uint8_t i = 0; i < 8; i++)
+                masked[i] = pattern[i] & mask;
+            uint8_t* row = buffer + page * width;
+            for (uint16_t col = x; col < xEnd; col++)
+                row[col] = op(row[col], masked[col & 7], mask);
+        }
+    };
+
+    if (mode == pico_oled::WriteMode::ADD) {
+        apply([](uint8_t d, uint8_t p, uint8_t) { return static_cast<uint8_t>(d | p); });
+    } else if (mode == pico_oled::WriteMode::SUBTRACT) {
+        apply([](uint8_t d, uint8_t p, uint8_t) { return static_cast<uint8_t>(d & ~p); });
+    } else if (mode == pico_oled::WriteMode::INVERT) {
+        apply([](uint8_t d, uint8_t p, uint8_t) { return static_cast<uint8_t>(d ^ p); });
+    } else if (mode == pico_oled::WriteMode::COPY) {
+        apply([](uint8_t d, uint8_t p, uint8_t m) { return static_cast<uint8_t>((d & ~m) | p); });
+    }
+}
+
+void FrameBuffer::clearRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    fillRegion(x, y, w, h, pico_oled::WriteMode::SUBTRACT);
+}
+
+void FrameBuffer::invertRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    fillRegion(x, y, w, h, pico_oled::WriteMode::INVERT);
+}
+
+void FrameBuffer::hspan(uint8_t x0, uint8_t x1, uint8_t y, pico_oled::WriteMode mode)
+{
+    if (x0 > x1)
+        std::swap(x0, x1);
+    if (x0 >= width)
+        return;
+    x1 = std::min<uint8_t>(x1, width - 1);
+    fillRegion(x0, y, static_cast<uint8_t>(x1 - x0 + 1), 1, mode);
+}
+
+void FrameBuffer::vspan(uint8_t x, uint8_t y0, uint8_t y1, pico_oled::WriteMode mode)
+{
+    if (y0 > y1)
+        std::swap(y0, y1);
+    if (y0 >= height)
+        return;
+    y1 = std::min<uint8_t>(y1, height - 1);
+    fillRegion(x, y0, 1, static_cast<uint8_t>(y1 - y0 + 1), mode);
+}
+
+void FrameBuffer::scrollRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h, int16_t dx, int16_t dy, uint8_t fill)
+{
+    if (w == 0 || h == 0 || x >= width || y >= height)
+        return;
+
+    // inclusive end of the region
+    const int xLast = std::min<int>(x + w, width) - 1;
+    const int yLast = std::min<int>(y + h, height) - 1;
+    const int len = xLast - x + 1;
+    const int firstPage = y >> 3;
+    const int lastPage = yLast >> 3;
+
+    // vertical part goes first and moves bits of every column, carrying them across page boundaries.
+    // Horizontal part keeps rows where they are, so fill pattern stays lined up with display rows
+    if (dy != 0) {
+        // rows getting their content from inside the region, the others are exposed and filled
+        const int movedFirst = std::max<int>(y, y + dy);
+        const int movedLast = std::min<int>(yLast, yLast + dy);
+        const int pageCount = (height + 7) >> 3;
+
+        for (int column = x; column <= xLast; column++) {
+            uint8_t* bytes = buffer + column;
+            auto page = [&](int p) -> uint8_t { return p >= 0 && p < pageCount ? bytes[p * width] : 0; };
+
+            // pages are done in the direction of the shift, so every page is read before it's overwritten
+            const int step = dy > 0 ? -1 : 1;
+            const int start = dy > 0 ? lastPage : firstPage;
+            for (int p = start; p >= firstPage && p <= lastPage; p += step) {
+                const uint8_t mask = rowMask(y, yLast, p);
+                const uint8_t moved = rowMask(movedFirst, movedLast, p);
+                const int srcRow = p * 8 - dy;
+                const int srcPage = srcRow >= 0 ? srcRow >> 3 : -((7 - srcRow) >> 3);
+                const auto bits = static_cast<uint8_t>((page(srcPage) | (page(srcPage + 1) << 8)) >> (srcRow - srcPage * 8));
+                bytes[p * width] = static_cast<uint8_t>((bytes[p * width] & ~mask) | (bits & moved) | (fill & mask & ~moved));
+            }
+        }
+    }
+
+    // horizontal part moves whole bytes along every page row
+    if (dx != 0) {
+        const int shift = std::min<int>(std::abs(dx), len);
+        for (int page = firstPage; page <= lastPage; page++) {
+            const uint8_t mask = rowMask(y, yLast, page);
+            uint8_t* row = buffer + page * width + x;
+            if (mask == 0xFF) {
+                if (dx > 0) {
+                    memmove(row + shift, row, len - shift);
+                    memset(row, fill, shift);
+                } else {
+                    memmove(row, row + shift, len - shift);
+                    memset(row + len - shift, fill, shift);
+                }
+            } else if (dx > 0) {
+                // rows of partial pages outside of the region stay where they are
+                for (int i = len - 1; i >= 0; i--) {
+                    const uint8_t moved = i >= shift ? row[i - shift] : fill;
+                    row[i] = static_cast<uint8_t>((row[i] & ~mask) | (moved & mask));
+                }
+            } else {
+                for (int i = 0; i < len; i++) {
+                    const uint8_t moved = i + shift < len ? row[i + shift] : fill;
+                    row[i] = static_cast<uint8_t>((row[i] & ~mask) | (moved & mask));
+                }
+            }
+        }
+    }
+}
+
+void FrameBuffer::copyRegion(const FrameBuffer& src, uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    if (src.width != width)
+        return;
+    // only rows present in both buffers can be copied
+    regionOp(buffer, src.buffer, width, std::min(height, src.height), x, y, w, h,
+        [](auto d, auto s, auto m) { return (d & ~m) | (s & m); });
+}
+
+size_t FrameBuffer::snapshot(uint8_t* dst, size_t capacity) const
+{
+    return pico_oled::rleEncode(buffer, bufferSize, dst, capacity);
+}
+
+void FrameBuffer::restore(const uint8_t* src)
+{
+    pico_oled::rleDecode(src, buffer, bufferSize);
+}
+
 void FrameBuffer::setBuffer(const uint8_t* new_buffer, size_t newBuffSz)
 {
-    memcpy(this->buffer.get(), new_buffer, std::min(bufferSize, newBuffSz));
+    memcpy(this->buffer, new_buffer, std::min(bufferSize, newBuffSz));
+}
+
+void FrameBuffer::setBuffer(uint8_t* new_buffer)
+{
+    // buffer allocated by constructor isn't needed anymore
+    this->owned.reset();
+    this->buffer = new_buffer;
 }
 
 void FrameBuffer::clear()
 {
     // zeroes out the buffer via memset function from string library
-    memset(this->buffer.get(), 0, bufferSize);
+    memset(this->buffer, 0, bufferSize);
 }
 
 uint8_t* FrameBuffer::get()
 {
-    return this->buffer.get();
+    return this->buffer;
+}
+
+const uint8_t* FrameBuffer::get() const
+{
+    return this->buffer;
 }
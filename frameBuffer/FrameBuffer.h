@@ -5,17 +5,75 @@
 #include <cstring>
 #include <memory>
 
+namespace pico_oled {
+
+/// \enum pico_oled::WriteMode
+enum class WriteMode : uint8_t {
+    /// sets pixel on regardless of its state
+    ADD = 0,
+    /// sets pixel off regardless of its state
+    SUBTRACT = 1,
+    /// inverts pixel, so 1->0 or 0->1
+    INVERT = 2,
+    /// replaces pixel with the source one. Used by block transfers, for a single pixel it works like ADD
+    COPY = 3,
+};
+
+/// 8x8 fill patterns, see FrameBuffer::fillRegion. Every byte is a column of 8 pixels, bit 0 being the top one
+/// sparse dots, 25% of pixels lit
+constexpr uint8_t PATTERN_25[8] = { 0x11, 0x44, 0x11, 0x44, 0x11, 0x44, 0x11, 0x44 };
+/// 1 px checkerboard, 50% of pixels lit
+constexpr uint8_t PATTERN_50[8] = { 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA };
+/// dense dots, 75% of pixels lit
+constexpr uint8_t PATTERN_75[8] = { 0xEE, 0xBB, 0xEE, 0xBB, 0xEE, 0xBB, 0xEE, 0xBB };
+/// 4 px checkerboard
+constexpr uint8_t PATTERN_CHECKER[8] = { 0x0F, 0x0F, 0x0F, 0x0F, 0xF0, 0xF0, 0xF0, 0xF0 };
+/// diagonal lines
+constexpr uint8_t PATTERN_HATCH[8] = { 0x11, 0x88, 0x44, 0x22, 0x11, 0x88, 0x44, 0x22 };
+/// horizontal lines on every other row
+constexpr uint8_t PATTERN_HLINES[8] = { 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55 };
+/// vertical lines on every other column
+constexpr uint8_t PATTERN_VLINES[8] = { 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00 };
+
+/// \brief Combines n bytes of src into dst according to write mode, 32 bits at a time where alignment allows.
+/// ADD ORs, SUBTRACT clears (AND-NOT), INVERT XORs and COPY replaces dst bytes
+void combineBytes(uint8_t* dst, const uint8_t* src, size_t n, WriteMode mode);
+
+}
+
 /// \brief Framebuffer class contains a pointer to buffer and functions for interacting with it
+///
+/// The buffer is page-major, same as display controller memory: each byte holds 8 vertical pixels of one column,
+/// bit 0 being the topmost one, and pages of `width` bytes follow each other top to bottom
 class FrameBuffer {
     size_t bufferSize { 0 };
-    std::unique_ptr<uint8_t[]> buffer { nullptr };
+    uint8_t width { 0 };
+    uint8_t height { 0 };
+    /// memory allocated by constructor, empty when buffer points to caller owned storage
+    std::unique_ptr<uint8_t[]> owned { nullptr };
+    uint8_t* buffer { nullptr };
 
 public:
-    /// Constructs frame buffer and allocates memory for buffer
+    /// Constructs frame buffer and allocates memory for buffer. Geometry is assumed to be 128 px wide
     explicit FrameBuffer(const size_t buffSz);
 
+    /// Constructs frame buffer for given geometry and allocates memory for buffer
+    /// \param width - width in pixels, which is also the amount of bytes in one page
+    /// \param height - height in pixels, rounded up to full 8 px pages for allocation
+    FrameBuffer(const uint8_t width, const uint8_t height);
+
+    /// Constructs frame buffer using caller owned storage, ex. a static array, which has to outlive it
+    /// \param storage - at least width * ceil(height / 8) bytes
+    /// \param width - width in pixels, which is also the amount of bytes in one page
+    /// \param height - height in pixels
+    FrameBuffer(uint8_t* storage, const uint8_t width, const uint8_t height);
+
     inline size_t GetBufferSize() const { return bufferSize; }
 
+    inline uint8_t GetWidth() const { return width; }
+
+    inline uint8_t GetHeight() const { return height; }
+
     /// \brief Performs OR logical operation on selected and provided byte
     ///
     /// ex. if byte in buffer at position n is 0b10001111 and provided byte is 0b11110000 the buffer at position n becomes 0b11111111
@@ -37,14 +95,82 @@ public:
     /// \param byte - provided byte to make operation
     void byteXOR(size_t n, uint8_t byte);
 
-    /// Replaces pointer with one pointing to a different buffer
+    /// \brief Applies write mode to every pixel of a rectangular region
+    ///
+    /// Region is clipped against the buffer once, then every covered page row is processed 32 bits at a time,
+    /// with partial pages at the top and bottom of the region masked
+    /// \param x, y - top left corner of the region in pixels
+    /// \param w, h - size of the region in pixels
+    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
+    void fillRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+    /// \brief Applies write mode to the pixels of a rectangular region that are set in an 8x8 pattern
+    ///
+    /// Buffer is page-major, so pattern bytes are columns of display memory and every covered byte takes a single
+    /// masked operation, same as a solid fill. Pattern is aligned to the buffer, so neighbouring fills line up
+    /// \param x, y - top left corner of the region in pixels
+    /// \param w, h - size of the region in pixels
+    /// \param pattern - 8 bytes, byte x & 7 holding column x with row y & 7 in bit y & 7, ex. PATTERN_50. nullptr fills solid
+    /// \param mode - ADD sets pattern pixels, SUBTRACT clears them, INVERT inverts them and COPY replaces the region with the pattern
+    void fillRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t* pattern, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+    /// \brief Sets all pixels of a rectangular region to 0. See fillRegion
+    void clearRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+    /// \brief Inverts all pixels of a rectangular region. See fillRegion
+    void invertRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+    /// \brief Applies write mode to a horizontal run of pixels from x0 to x1 (inclusive) on row y.
+    /// All pixels share one bit mask, so this is a run of same mask byte operations
+    void hspan(uint8_t x0, uint8_t x1, uint8_t y, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+    /// \brief Applies write mode to a vertical run of pixels from y0 to y1 (inclusive) in column x.
+    /// Every covered page is a single masked byte operation
+    void vspan(uint8_t x, uint8_t y0, uint8_t y1, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+    /// \brief Moves content of a rectangular region by dx, dy pixels, ex. to scroll a log or a chart by a few pixels
+    /// instead of redrawing it
+    ///
+    /// Horizontal moves are a memmove of every page row, vertical ones shift bits of every column across page boundaries.
+    /// Content moved out of the region is lost, the exposed area is filled with fill
+    /// \param x, y - top left corner of the region in pixels
+    /// \param w, h - size of the region in pixels
+    /// \param dx, dy - distance to move the content by, positive values move it right and down
+    /// \param fill - display memory byte to fill exposed area with, 0x00 for dark, 0xFF for lit pixels or any pattern
+    void scrollRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h, int16_t dx, int16_t dy, uint8_t fill = 0x00);
+
+    /// \brief Copies a rectangular region from another frame buffer into the same position of this one
+    ///
+    /// Both buffers need to have the same width, otherwise nothing is copied
+    /// \param src - frame buffer to copy pixels from
+    /// \param x, y - top left corner of the region in pixels
+    /// \param w, h - size of the region in pixels
+    void copyRegion(const FrameBuffer& src, uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+    /// \brief Stores run length encoded copy of the buffer in dst, see RleDecoder for the format
+    /// \param capacity - size of dst, encoded buffer takes at most GetBufferSize() + GetBufferSize() / 128 + 1 bytes
+    /// \return amount of bytes stored, 0 if they don't fit into capacity
+    size_t snapshot(uint8_t* dst, size_t capacity) const;
+
+    /// \brief Restores buffer content from a snapshot
+    /// \param src - data stored by snapshot of a buffer of the same size
+    void restore(const uint8_t* src);
+
+    /// Copies content of a different buffer into this one, at most newBuffSz bytes
     void setBuffer(const uint8_t* new_buffer, size_t newBuffSz);
 
+    /// \brief Replaces pointer with one pointing to caller owned storage of the same size, nothing is copied.
+    /// Memory allocated by constructor is freed, storage has to outlive the frame buffer or another setBuffer call
+    void setBuffer(uint8_t* new_buffer);
+
     /// Zeroes out the buffer aka set buffer to all 0
     void clear();
 
     /// Returns a pointer to the buffer
     uint8_t* get();
+
+    /// Returns a read only pointer to the buffer
+    const uint8_t* get() const;
 };
 
 #endif // OLED_FRAMEBUFFER_H
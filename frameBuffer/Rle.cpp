@@ -0,0 +1,99 @@
+#include "Rle.h"
+
+#include <cstring>
+
+namespace pico_oled {
+
+void RleDecoder::read(uint8_t* out, size_t n)
+{
+    while (n) {
+        if (remaining == 0) {
+            const uint8_t control = *src++;
+            repeat = control >= 0x80;
+            remaining = repeat ? control - 0x7E : control + 1;
+        }
+        const uint8_t count = n < remaining ? static_cast<uint8_t>(n) : remaining;
+        if (repeat) {
+            memset(out, *src, count);
+        } else {
+            memcpy(out, src, count);
+            src += count;
+        }
+        remaining -= count;
+        // value of a run stays under src until the run is used up
+        if (repeat && remaining == 0)
+            src++;
+        out += count;
+        n -= count;
+    }
+}
+
+void RleDecoder::skip(size_t n)
+{
+    while (n) {
+        if (remaining == 0) {
+            const uint8_t control = *src++;
+            repeat = control >= 0x80;
+            remaining = repeat ? control - 0x7E : control + 1;
+        }
+        const uint8_t count = n < remaining ? static_cast<uint8_t>(n) : remaining;
+        if (!repeat)
+            src += count;
+        remaining -= count;
+        if (repeat && remaining == 0)
+            src++;
+        n -= count;
+    }
+}
+
+size_t rleDecode(const uint8_t* src, uint8_t* dst, size_t n)
+{
+    RleDecoder decoder(src);
+    decoder.read(dst, n);
+    return decoder.position() - src;
+}
+
+size_t rleEncode(const uint8_t* src, size_t n, uint8_t* dst, size_t capacity)
+{
+    size_t out = 0;
+    size_t literalStart = 0;
+    size_t literalCount = 0;
+
+    // writes pending literal bytes as packets of up to 128
+    auto flushLiterals = [&]() {
+        while (literalCount) {
+            const size_t count = literalCount < 128 ? literalCount : 128;
+            if (out + 1 + count > capacity)
+                return false;
+            dst[out++] = static_cast<uint8_t>(count - 1);
+            memcpy(dst + out, src + literalStart, count);
+            out += count;
+            literalStart += count;
+            literalCount -= count;
+        }
+        return true;
+    };
+
+    size_t pos = 0;
+    while (pos < n) {
+        size_t run = 1;
+        while (pos + run < n && run < 129 && src[pos + run] == src[pos])
+            run++;
+
+        // a pair of bytes is cheaper as a run only when it doesn't split literals
+        if (run >= 3 || (run == 2 && literalCount == 0)) {
+            if (!flushLiterals() || out + 2 > capacity)
+                return 0;
+            dst[out++] = static_cast<uint8_t>(0x7E + run);
+            dst[out++] = src[pos];
+            pos += run;
+            literalStart = pos;
+        } else {
+            literalCount++;
+            pos++;
+        }
+    }
+    return flushLiterals() ? out : 0;
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef OLED_RLE_H
+#define OLED_RLE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pico_oled {
+
+/// \class RleDecoder Rle.h "pico-oled/frameBuffer/Rle.h"
+/// \brief Streams bytes out of run length encoded data, as many at a time as the caller wants.
+///
+/// Encoded data is a sequence of packets, each starting with a control byte c:
+/// c below 0x80 is followed by c + 1 literal bytes, c from 0x80 up is followed by one byte repeated c - 0x7E times.
+/// Page-major images compress well this way, as empty and filled areas become long runs of 0x00 and 0xFF.
+/// The decoder keeps only the current packet, so images can be decoded page by page straight into a frame buffer
+class RleDecoder {
+    const uint8_t* src;
+    uint8_t remaining { 0 };
+    bool repeat { false };
+
+public:
+    /// \param src - encoded data
+    explicit RleDecoder(const uint8_t* src) : src(src) { }
+
+    /// \brief Decodes next n bytes into out
+    void read(uint8_t* out, size_t n);
+
+    /// \brief Skips next n bytes
+    void skip(size_t n);
+
+    /// \brief Returns pointer to the first encoded byte not used yet, valid when the last packet was read completely
+    inline const uint8_t* position() const { return src; }
+};
+
+/// \brief Decodes n bytes of run length encoded data into dst. See RleDecoder for the format
+/// \return amount of encoded bytes used
+size_t rleDecode(const uint8_t* src, uint8_t* dst, size_t n);
+
+/// \brief Run length encodes n bytes of src into dst. See RleDecoder for the format.
+/// Encoded data takes at most n + ceil(n / 128) bytes
+/// \param capacity - size of dst
+/// \return amount of encoded bytes, 0 if they don't fit into capacity
+size_t rleEncode(const uint8_t* src, size_t n, uint8_t* dst, size_t capacity);
+
+}
+
+#endif // OLED_RLE_H
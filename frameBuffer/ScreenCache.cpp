@@ -0,0 +1,88 @@
+#include "ScreenCache.h"
+
+namespace pico_oled {
+
+ScreenCache::ScreenCache(uint8_t* arena, size_t arenaSize)
+    : arena(arena)
+    , arenaSize(arenaSize)
+{
+}
+
+uint8_t ScreenCache::find(uint16_t id) const
+{
+    uint8_t i = 0;
+    while (i < count && entries[i].id != id)
+        i++;
+    return i;
+}
+
+void ScreenCache::drop(uint8_t index)
+{
+    const Entry dropped = entries[index];
+
+    // entries are kept in arena order, so everything after the dropped one moves down by its size
+    memmove(arena + dropped.offset, arena + dropped.offset + dropped.size, used - dropped.offset - dropped.size);
+    for (uint8_t i = index; i + 1 < count; i++) {
+        entries[i] = entries[i + 1];
+        entries[i].offset -= dropped.size;
+    }
+    used -= dropped.size;
+    count--;
+}
+
+void ScreenCache::dropOldest()
+{
+    uint8_t oldest = 0;
+    for (uint8_t i = 1; i < count; i++) {
+        if (entries[i].lastUse < entries[oldest].lastUse)
+            oldest = i;
+    }
+    this->drop(oldest);
+}
+
+bool ScreenCache::store(uint16_t id, const FrameBuffer& frameBuffer)
+{
+    this->invalidate(id);
+    if (count == MAX_SCREENS)
+        this->dropOldest();
+
+    // snapshot is encoded straight into free space, and tried again with more of it if it doesn't fit
+    size_t size;
+    while ((size = frameBuffer.snapshot(arena + used, arenaSize - used)) == 0) {
+        if (count == 0)
+            return false;
+        this->dropOldest();
+    }
+
+    entries[count++] = { id, used, size, frameBuffer.GetBufferSize(), ++clock };
+    used += size;
+    return true;
+}
+
+bool ScreenCache::restore(uint16_t id, FrameBuffer& frameBuffer)
+{
+    const uint8_t i = this->find(id);
+    if (i == count || entries[i].bufferSize != frameBuffer.GetBufferSize()) {
+        misses++;
+        return false;
+    }
+    frameBuffer.restore(arena + entries[i].offset);
+    entries[i].lastUse = ++clock;
+    hits++;
+    return true;
+}
+
+void ScreenCache::invalidate(uint16_t id)
+{
+    const uint8_t i = this->find(id);
+    if (i < count)
+        this->drop(i);
+}
+
+void ScreenCache::clear()
+{
+    count = 0;
+    used = 0;
+}
+
+}
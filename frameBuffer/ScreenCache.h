@@ -0,0 +1,83 @@
+#ifndef OLED_SCREENCACHE_H
+#define OLED_SCREENCACHE_H
+
+#include "FrameBuffer.h"
+
+namespace pico_oled {
+
+/// \class ScreenCache ScreenCache.h "pico-oled/frameBuffer/ScreenCache.h"
+/// \brief Keeps run length encoded snapshots of recently shown screens in a fixed arena.
+///
+/// Going back to a cached screen is a decode into the frame buffer instead of rendering it again.
+/// When a new snapshot doesn't fit, least recently used ones are dropped until it does. Screens are packed at the
+/// start of the arena, so dropping one moves the ones stored after it, there is no fragmentation.
+/// Typical UI screens take 300 to 600 bytes, so a 2 KB arena holds several of them
+class ScreenCache {
+public:
+    /// maximum amount of screens kept, no matter how much space is left in the arena
+    static constexpr uint8_t MAX_SCREENS = 8;
+
+private:
+    struct Entry {
+        uint16_t id;
+        size_t offset;
+        size_t size;
+        size_t bufferSize;
+        uint32_t lastUse;
+    };
+
+    uint8_t* arena;
+    size_t arenaSize;
+    size_t used { 0 };
+    Entry entries[MAX_SCREENS] {};
+    uint8_t count { 0 };
+    uint32_t clock { 0 };
+    uint32_t hits { 0 };
+    uint32_t misses { 0 };
+
+    /// returns index of entry with id, or count if there is none
+    uint8_t find(uint16_t id) const;
+
+    /// drops entry and packs the ones stored after it
+    void drop(uint8_t index);
+
+    /// drops least recently used entry
+    void dropOldest();
+
+public:
+    /// \param arena - memory for snapshots, it has to stay alive while the cache is used
+    /// \param arenaSize - size of arena in bytes
+    ScreenCache(uint8_t* arena, size_t arenaSize);
+
+    /// \brief Stores snapshot of frame buffer under id, replacing the one stored under the same id before
+    /// \param id - any number identifying the screen, ex. menu page
+    /// \return false if the snapshot doesn't fit even into an empty arena
+    bool store(uint16_t id, const FrameBuffer& frameBuffer);
+
+    /// \brief Restores screen stored under id into frame buffer. Counts as a hit or a miss
+    /// \return false if there is no such screen or it was taken from a frame buffer of different size,
+    /// the screen has to be rendered then
+    bool restore(uint16_t id, FrameBuffer& frameBuffer);
+
+    /// \brief Drops screen stored under id, ex. after its content changed
+    void invalidate(uint16_t id);
+
+    /// \brief Drops all screens, hit and miss counts stay
+    void clear();
+
+    inline uint32_t GetHits() const { return hits; }
+
+    inline uint32_t GetMisses() const { return misses; }
+
+    /// \brief Returns percentage of restore calls that found their screen
+    inline uint8_t GetHitRate() const { return hits + misses ? static_cast<uint8_t>(100ULL * hits / (hits + misses)) : 0; }
+
+    /// \brief Returns amount of arena bytes taken by stored screens
+    inline size_t GetBytesHeld() const { return used; }
+
+    inline uint8_t GetScreenCount() const { return count; }
+};
+
+}
+
+#endif // OLED_SCREENCACHE_H
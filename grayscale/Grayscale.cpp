@@ -0,0 +1,132 @@
+#include "Grayscale.h"
+
+#include "pico/time.h"
+
+namespace {
+
+// plane shown by every sub frame, the high one twice as long as the low one
+constexpr uint8_t SCHEDULE[] = { 1, 1, 0 };
+
+// display clock register giving the fastest panel refresh, and its value after reset
+constexpr uint8_t FAST_CLOCK = 0xF0;
+constexpr uint8_t DEFAULT_CLOCK = 0x80;
+
+}
+
+namespace pico_oled {
+
+Grayscale::Grayscale(OLED* display, uint16_t minimumRate)
+    : display(display)
+    , planes { display->createCanvas(), display->createCanvas() }
+    , minimumRate(minimumRate)
+{
+    this->attached = this->display->addLayer(this->planes[shownPlane], WriteMode::COPY);
+    this->display->setClockDivider(FAST_CLOCK);
+}
+
+Grayscale::~Grayscale()
+{
+    this->display->removeLayer(this->planes[shownPlane]);
+    this->display->setClockDivider(DEFAULT_CLOCK);
+}
+
+void Grayscale::setPixel(int16_t x, int16_t y, uint8_t level)
+{
+    this->draw(level, [x, y](Canvas* canvas, WriteMode mode) { canvas->setPixel(x, y, mode); });
+}
+
+void Grayscale::fillRegion(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level)
+{
+    this->draw(level, [=](Canvas* canvas, WriteMode mode) { canvas->fillRegion(x, y, w, h, mode); });
+}
+
+void Grayscale::clear()
+{
+    this->planes[0].clear();
+    this->planes[1].clear();
+    dirty = true;
+}
+
+bool Grayscale::showPlane(uint8_t plane)
+{
+    if (attached && plane == shownPlane)
+        return true;
+    if (attached)
+        this->display->removeLayer(this->planes[shownPlane]);
+    shownPlane = plane;
+    attached = this->display->addLayer(this->planes[plane], WriteMode::COPY);
+    return attached;
+}
+
+uint8_t Grayscale::comparePlanes() const
+{
+    const FrameBuffer& low = this->planes[0].GetFrameBuffer();
+    const FrameBuffer& high = this->planes[1].GetFrameBuffer();
+    const size_t pageSize = low.GetWidth();
+    const uint8_t pageCount = (low.GetHeight() + 7) / 8;
+
+    uint8_t mask = 0;
+    for (uint8_t page = 0; page < pageCount; page++) {
+        if (memcmp(low.get() + page * pageSize, high.get() + page * pageSize, pageSize) != 0)
+            mask |= 1 << (page & 7);
+    }
+    // portrait buffer pages don't line up with display pages, any difference means sending everything
+    if (this->display->IsPortrait() && mask)
+        mask = 0xFF;
+    return mask;
+}
+
+bool Grayscale::update()
+{
+    const uint64_t start = time_us_64();
+
+    // in fallback only the high plane is shown, and sent when it changes
+    const uint8_t plane = stats.fallback ? 1 : SCHEDULE[phase];
+    const bool changed = plane != shownPlane;
+    if (!this->showPlane(plane))
+        return false;
+
+    uint8_t pages = 0;
+    if (dirty) {
+        differingPages = this->comparePlanes();
+        pages = 0xFF;
+        dirty = false;
+    } else if (changed) {
+        pages = differingPages;
+    }
+    if (pages)
+        this->display->sendPages(pages);
+
+    const uint64_t end = time_us_64();
+    stats.lastFlushUs = static_cast<uint32_t>(end - start);
+    stats.lastPages = static_cast<uint8_t>(__builtin_popcount(pages));
+    if (stats.fallback)
+        return true;
+
+    phase = (phase + 1) % sizeof(SCHEDULE);
+
+    // measure shown rate over a window of sub frames, the first call only starts the clock
+    if (windowFrames == 0) {
+        windowStart = start;
+    }
+    if (++windowFrames >= STATS_WINDOW) {
+        const uint64_t elapsed = end - windowStart;
+        stats.subframeRate = elapsed ? static_cast<uint32_t>(STATS_WINDOW * 1000000ULL / elapsed) : UINT32_MAX;
+        windowFrames = 0;
+        if (stats.subframeRate < minimumRate) {
+            stats.fallback = true;
+            dirty = true;
+        }
+    }
+    return true;
+}
+
+void Grayscale::setMinimumRate(uint16_t subframesPerSecond)
+{
+    minimumRate = subframesPerSecond;
+    stats.fallback = false;
+    windowFrames = 0;
+    dirty = true;
+}
+
+}
@@ -0,0 +1,105 @@
+#ifndef OLED_GRAYSCALE_H
+#define OLED_GRAYSCALE_H
+
+#include "../oled.hpp"
+
+namespace pico_oled {
+
+/// \brief Statistics of grayscale flushing, see Grayscale::GetStats
+struct GrayscaleStats {
+    /// sub frames shown per second, measured over the last Grayscale::STATS_WINDOW sub frames
+    uint32_t subframeRate;
+    /// time it took to send the last sub frame in microseconds
+    uint32_t lastFlushUs;
+    /// amount of pages sent with the last sub frame
+    uint8_t lastPages;
+    /// true once grayscale was given up because sub frames couldn't be sent fast enough
+    bool fallback;
+};
+
+/// \class Grayscale Grayscale.h "pico-oled/grayscale/Grayscale.h"
+/// \brief Shows 4 levels of gray on a mono display by cycling two bitplanes.
+///
+/// Every pixel has a 2 bit level, kept in two canvases. update() shows one plane per call following the
+/// schedule high, high, low, so a pixel is lit for 0, 1, 2 or 3 thirds of the time. Planes are swapped as a COPY layer
+/// over the display frame buffer, and only pages that differ between the planes are sent, so mostly black and white
+/// screens with a few gray details cycle at a high rate. Display clock is raised while grayscale is in use to make
+/// the panel refresh faster than the planes change.
+/// When sub frames can't be shown at least minimumRate times per second, the flicker would be visible, so it falls
+/// back to showing the high plane only, that is levels 2 and 3 lit.
+class Grayscale {
+public:
+    /// amount of sub frames the shown rate is measured over
+    static constexpr uint8_t STATS_WINDOW = 30;
+
+private:
+    OLED* display;
+    Canvas planes[2];
+    uint8_t phase { 0 };
+    uint8_t shownPlane { 1 };
+    bool attached { false };
+    bool dirty { true };
+    uint8_t differingPages { 0 };
+    uint16_t minimumRate;
+    uint64_t windowStart { 0 };
+    uint8_t windowFrames { 0 };
+    GrayscaleStats stats {};
+
+    /// puts plane in place of the currently shown one as a layer of the display
+    bool showPlane(uint8_t plane);
+
+    /// returns mask of display pages whose content differs between the planes
+    uint8_t comparePlanes() const;
+
+public:
+    /// \brief Creates both planes for display and attaches the high one as a layer.
+    /// Create it after display orientation and portrait mode are set
+    /// \param display - pointer to an initialised display
+    /// \param minimumRate - sub frames per second below which grayscale falls back to 1 bit, 90 being 30 full cycles
+    explicit Grayscale(OLED* display, uint16_t minimumRate = 90);
+
+    /// Detaches planes from display and restores its clock
+    ~Grayscale();
+
+    Grayscale(const Grayscale&) = delete;
+    Grayscale& operator=(const Grayscale&) = delete;
+
+    /// \brief Draws with any renderer in one gray level: draw is called once per plane with the canvas of the plane and
+    /// the write mode setting or clearing level bit of it, ex.
+    /// `gray.draw(2, [](Canvas* c, WriteMode m) { drawText(c, font_8x8, "gray", 0, 0, m); });`
+    /// \param level - 0 for black up to 3 for fully lit
+    /// \param draw - callable taking Canvas* and WriteMode
+    template <typename Draw>
+    inline void draw(const uint8_t level, Draw draw)
+    {
+        for (uint8_t bit = 0; bit < 2; bit++) {
+            draw(&planes[bit], ((level >> bit) & 1) ? WriteMode::ADD : WriteMode::SUBTRACT);
+        }
+        dirty = true;
+    }
+
+    /// \brief Sets pixel to a gray level
+    /// \param level - 0 for black up to 3 for fully lit
+    void setPixel(int16_t x, int16_t y, uint8_t level);
+
+    /// \brief Sets all pixels of a rectangular region to a gray level
+    /// \param level - 0 for black up to 3 for fully lit
+    void fillRegion(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level);
+
+    /// \brief Sets all pixels to 0 level
+    void clear();
+
+    /// \brief Shows the next sub frame, call it as often as possible.
+    /// After drawing the whole screen is sent once, later only pages that differ between the planes, when the plane changes
+    /// \return false if display has no free layer for the planes, nothing is shown then
+    bool update();
+
+    /// \brief Changes sub frame rate needed for grayscale and leaves fallback mode, so grayscale is tried again
+    void setMinimumRate(uint16_t subframesPerSecond);
+
+    inline GrayscaleStats GetStats() const { return stats; }
+};
+
+}
+
+#endif // OLED_GRAYSCALE_H
@@ -1,135 +1,223 @@
-#ifndef OLED_IFACE_H
-#define OLED_IFACE_H
-
-#include "frameBuffer/FrameBuffer.h"
-#include "hardware/i2c.h"
-#include <cstdint>
-#include <cstring>
-#include <memory>
-
-namespace pico_oled {
-
-/// \enum pico_oled::Type
-enum class Type : uint8_t {
-    /// Display type SSD1306
-    SSD1306,
-    /// Display type SH1106
-    SH1106
-};
-
-/// \enum pico_oled::Size
-enum class Size : uint8_t {
-    /// Display size W128xH64
-    W128xH64,
-    /// Display size W128xH32
-    W128xH32
-};
-
-/// \enum pico_oled::WriteMode
-enum class WriteMode : uint8_t {
-    /// sets pixel on regardless of its state
-    ADD = 0,
-    /// sets pixel off regardless of its state
-    SUBTRACT = 1,
-    /// inverts pixel, so 1->0 or 0->1
-    INVERT = 2,
-};
-
-/// \class OLED oled.hpp "pico-oled/oled.hpp"
-/// \brief OLED class represents underlying i2c connection to display
-class OLED {
-protected:
-    i2c_inst* i2CInst { nullptr };
-    uint8_t address { 0x00 };
-    Type type;
-    Size size;
-    std::unique_ptr<FrameBuffer> frameBuffer { nullptr };
-    uint8_t width { 128 };
-    uint8_t height { 64 };
-    bool inverted { false };
-
-    virtual void cmd(const uint8_t& command) = 0;
-
-public:
-    /// \brief Generic OLED constructor for property setting
-    /// \param i2CInst - i2c instance. Either i2c0 or i2c1
-    /// \param Address - display i2c address. usually for 128x32 0x3C and for 128x64 0x3D
-    /// \param type - display type. Acceptable values SSD1306 or SH1106
-    /// \param size - display size. Acceptable values W128xH32 or W128xH64
-    explicit OLED(i2c_inst* i2CInst, uint8_t Address, Type type, Size size) : i2CInst(i2CInst), address(Address), type(type), size(size)
-    {
-        if (size == Size::W128xH32) {
-            this->height = 32;
-        }
-    }
-
-    virtual bool IsConnected() = 0;
-
-    /// \brief Set pixel operates frame buffer
-    /// x is the x position of pixel you want to change. values 0 - 127
-    /// y is the y position of pixel you want to change. values 0 - 31 or 0 - 63
-    /// \param x - position of pixel you want to change. values 0 - 127
-    /// \param y - position of pixel you want to change. values 0 - 31 or 0 - 63
-    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
-    virtual void setPixel(const uint8_t x, const uint8_t y, const WriteMode mode = WriteMode::ADD) = 0;
-
-    /// \brief Sends frame buffer to display so that it updated
-    virtual void sendBuffer() = 0;
-
-    /// \brief Adds bitmap image to frame buffer
-    /// \param anchorX - sets start point of where to put the image on the screen
-    /// \param anchorY - sets start point of where to put the image on the screen
-    /// \param image_width - width of the image in pixels
-    /// \param image_height - height of the image in pixels
-    /// \param image - pointer to uint8_t (unsigned char) array containing image data
-    /// \param mode - mode describes setting behavior. See WriteMode doc for more information
-    inline void addBitmapImage(const int16_t anchorX, const int16_t anchorY, const uint8_t image_width, const uint8_t image_height, const uint8_t* image, const WriteMode mode = WriteMode::ADD)
-    {
-        uint8_t byte { 0x00 };
-        // goes over every single bit in image and sets pixel data on its coordinates
-        for (uint8_t y = 0; y < image_height; y++) {
-            for (uint8_t x = 0; x < image_width / 8; x++) {
-                byte = image[y * (image_width / 8) + x];
-                for (uint8_t z = 0; z < 8; z++) {
-                    if ((byte >> (7 - z)) & 1) {
-                        int16_t xCoord = x * 8 + z + anchorX;
-                        int16_t yCoord = y + anchorY;
-                        if (xCoord >= 0 && xCoord < width
-                            && yCoord >= 0 && yCoord < height) {
-                            this->setPixel(static_cast<uint8_t>(xCoord), static_cast<uint8_t>(yCoord), mode);
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    /// \brief Manually set frame buffer. make sure it's correct size of 1024 bytes
-    /// \param buffer - pointer to a new buffer
-    inline void setBuffer(const uint8_t* buffer, const size_t bufferSz)
-    {
-        if (bufferSz != 1024) return;
-        this->frameBuffer->setBuffer(buffer, bufferSz);
-    }
-
-    /// \brief Flips the display
-    /// \param orientation - 0 for not flipped, 1 for flipped display
-    virtual void setOrientation(bool orientation) = 0;
-
-    /// \brief Clears frame buffer aka set all bytes to 0
-    inline void clear()
-    {
-        this->frameBuffer->clear();
-    }
-
-    /// \brief Inverts screen on hardware level. Way more efficient than setting buffer to all ones and then using WriteMode subtract.
-    virtual void invertDisplay() = 0;
-
-    /// \brief Sets display contrast according to ssd1306 documentation
-    /// \param contrast - accepted values of 0 to 255 to set the contrast
-    virtual void setContrast(const uint8_t contrast) = 0;
-};
-
-}
-
+#ifndef OLED_IFACE_H
+#define OLED_IFACE_H
+
+#include "canvas.hpp"
+#include "frameBuffer/Blit.h"
+#include "hardware/i2c.h"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace pico_oled {
+
+/// \enum pico_oled::Type
+enum class Type : uint8_t {
+    /// Display type SSD1306
+    SSD1306,
+    /// Display type SH1106
+    SH1106
+};
+
+/// \enum pico_oled::Size
+enum class Size : uint8_t {
+    /// Display size W128xH64
+    W128xH64,
+    /// Display size W128xH32
+    W128xH32
+};
+
+/// \class OLED oled.hpp "pico-oled/oled.hpp"
+/// \brief OLED class represents underlying i2c connection to display
+class OLED : public Canvas {
+public:
+    /// maximum amount of layers composited over the frame buffer when it's sent to display
+    static constexpr uint8_t MAX_LAYERS = 4;
+
+protected:
+    /// canvas composited over the frame buffer and the way it's combined with the image below it
+    struct Layer {
+        const Canvas* canvas;
+        WriteMode mode;
+    };
+
+    i2c_inst* i2CInst { nullptr };
+    uint8_t address { 0x00 };
+    Type type;
+    Size size;
+    bool inverted { false };
+    Layer layers[MAX_LAYERS] {};
+    uint8_t layerCount { 0 };
+    bool portrait { false };
+    /// geometry of the frame buffer in display memory layout, kept while portrait buffer is in use
+    uint8_t bufferWidth { 0 };
+    uint8_t bufferHeight { 0 };
+    /// landscape frame buffer, put aside while portrait buffer is in use so storage attached with setBuffer or
+    /// shareBuffer stays linked to the display
+    std::unique_ptr<FrameBuffer> landscapeBuffer { nullptr };
+
+    virtual void cmd(const uint8_t& command) = 0;
+
+    /// \brief Writes len bytes of the image to be shown into out, starting at offset of frame buffer.
+    /// Layers are composited here while the bytes are being prepared for the bus, so there is no intermediate full frame copy
+    inline void renderBytes(uint8_t* out, const size_t offset, const size_t len) const
+    {
+        memcpy(out, this->frameBuffer->get() + offset, len);
+        for (uint8_t i = 0; i < layerCount; i++) {
+            combineBytes(out, layers[i].canvas->GetFrameBuffer().get() + offset, len, layers[i].mode);
+        }
+    }
+
+    /// \brief Writes one display memory page of the image to be shown into out, that is GetPageSize() bytes.
+    ///
+    /// In portrait mode the page is put together from 8x8 blocks of the portrait buffer, which are transposed into
+    /// display memory order on the fly. Logical pixel x, y ends up on display column y, row (display height - 1 - x)
+    inline void renderPage(uint8_t* out, const uint8_t page) const
+    {
+        if (!portrait) {
+            this->renderBytes(out, static_cast<size_t>(page) * bufferWidth, bufferWidth);
+            return;
+        }
+
+        // display page is made of the same 8 portrait columns of every portrait page, the last display page being the leftmost columns
+        const uint8_t stride = this->frameBuffer->GetWidth();
+        const size_t column = stride - 8 - page * 8;
+        for (uint8_t block = 0; block < height / 8; block++) {
+            alignas(4) uint8_t strip[8];
+            this->renderBytes(strip, block * stride + column, 8);
+
+            // columns come in right to left, so reversing both ends of the transpose turns them into display columns
+            uint8_t rows[8], columns[8];
+            for (uint8_t i = 0; i < 8; i++)
+                rows[i] = strip[7 - i];
+            transpose8x8(rows, columns);
+            for (uint8_t i = 0; i < 8; i++)
+                out[block * 8 + i] = columns[7 - i];
+        }
+
+        // columns past the display, ex. on SH1106, stay dark
+        memset(out + height, 0, bufferWidth - height);
+    }
+
+    /// \brief Amount of bytes in one display memory page
+    inline uint8_t GetPageSize() const { return bufferWidth; }
+
+public:
+    /// \brief Generic OLED constructor for property setting
+    /// \param i2CInst - i2c instance. Either i2c0 or i2c1
+    /// \param Address - display i2c address. usually for 128x32 0x3C and for 128x64 0x3D
+    /// \param type - display type. Acceptable values SSD1306 or SH1106
+    /// \param size - display size. Acceptable values W128xH32 or W128xH64
+    explicit OLED(i2c_inst* i2CInst, uint8_t Address, Type type, Size size) : i2CInst(i2CInst), address(Address), type(type), size(size)
+    {
+        if (size == Size::W128xH32) {
+            this->height = 32;
+        }
+        this->resetViewports();
+    }
+
+    virtual bool IsConnected() = 0;
+
+    /// \brief Sends frame buffer to display so that it updated
+    virtual void sendBuffer() = 0;
+
+    /// \brief Sends only selected pages of frame buffer to display, the rest of display memory stays as it is
+    /// \param pageMask - bit n set sends page n, that is rows 8n to 8n+7 of display memory
+    virtual void sendPages(uint8_t pageMask) = 0;
+
+    /// \brief Sets display clock divide ratio and oscillator frequency register, which decides how often the panel is refreshed.
+    /// Higher values of the top nibble and lower values of the bottom one give faster refresh
+    /// \param value - oscillator frequency in bits 7-4, divide ratio minus 1 in bits 3-0. 0x80 after reset
+    virtual void setClockDivider(uint8_t value) = 0;
+
+    /// \brief Creates an off-screen canvas with the same size and memory layout as the display, ex. to be used as a layer
+    inline Canvas createCanvas() const
+    {
+        return Canvas(width, height, this->frameBuffer->GetWidth(), rowScale);
+    }
+
+    /// \brief Switches between landscape and portrait mode.
+    ///
+    /// In portrait mode the canvas is as wide as the display is tall and 128 px tall, ex. 64x128, and the image is
+    /// turned by 90 degrees while being sent to display, so all renderers work unchanged at their usual speed.
+    /// Combined with setOrientation(true) the image is turned by 270 degrees instead.
+    /// Portrait mode draws into a frame buffer of its own, layers are removed and viewports reset. Landscape frame buffer
+    /// is put aside meanwhile and taken back by setPortrait(false) with its content, so storage attached with
+    /// setBuffer or shared with other canvases through shareBuffer is linked to the display again. While in portrait
+    /// mode drawing into such shared storage is not shown, and setBuffer or shareBuffer apply to the portrait buffer only
+    /// \param enable - true for portrait, false for landscape mode
+    /// \return false if display doesn't support portrait mode, that is 128x32 SSD1306 with its doubled rows
+    inline bool setPortrait(const bool enable)
+    {
+        if (rowScale != 1)
+            return false;
+        if (enable == portrait)
+            return true;
+
+        const uint8_t oldWidth = width;
+        width = height;
+        height = oldWidth;
+        portrait = enable;
+        if (portrait) {
+            this->landscapeBuffer = std::move(this->frameBuffer);
+            this->frameBuffer = std::make_unique<FrameBuffer>(width, height);
+        } else {
+            this->frameBuffer = std::move(this->landscapeBuffer);
+        }
+        this->clearLayers();
+        this->resetViewports();
+        return true;
+    }
+
+    /// \brief Returns true if display is in portrait mode, see setPortrait
+    inline bool IsPortrait() const { return portrait; }
+
+    /// \brief Composites canvas over the frame buffer every time it's sent to display, frame buffer itself stays untouched.
+    ///
+    /// Useful for keeping static parts of the screen in their own canvas instead of redrawing them after every clear.
+    /// Layers are applied in the order they were added. ADD ORs layer pixels in, SUBTRACT clears them (AND-NOT),
+    /// INVERT flips them (XOR) and COPY replaces everything below the layer
+    /// \param canvas - canvas created by createCanvas, it has to stay alive while being a layer
+    /// \param mode - way the layer is combined with the image below it
+    /// \return false if canvas doesn't match the display or there are MAX_LAYERS layers already
+    inline bool addLayer(const Canvas& canvas, const WriteMode mode = WriteMode::ADD)
+    {
+        const FrameBuffer& layerBuffer = canvas.GetFrameBuffer();
+        if (layerCount >= MAX_LAYERS || layerBuffer.GetWidth() != this->frameBuffer->GetWidth()
+            || layerBuffer.GetHeight() < height * rowScale)
+            return false;
+        layers[layerCount++] = { &canvas, mode };
+        return true;
+    }
+
+    /// \brief Stops compositing canvas over the frame buffer
+    inline void removeLayer(const Canvas& canvas)
+    {
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < layerCount; i++) {
+            if (layers[i].canvas != &canvas)
+                layers[kept++] = layers[i];
+        }
+        layerCount = kept;
+    }
+
+    /// \brief Removes all layers
+    inline void clearLayers()
+    {
+        layerCount = 0;
+    }
+
+    /// \brief Flips the display
+    /// \param orientation - 0 for not flipped, 1 for flipped display
+    virtual void setOrientation(bool orientation) = 0;
+
+    /// \brief Inverts screen on hardware level. Way more efficient than setting buffer to all ones and then using WriteMode subtract.
+    virtual void invertDisplay() = 0;
+
+    /// \brief Sets display contrast according to ssd1306 documentation
+    /// \param contrast - accepted values of 0 to 255 to set the contrast
+    virtual void setContrast(const uint8_t contrast) = 0;
+};
+
+}
+
 #endif // OLED_IFACE_H
\ No newline at end of file
@@ -11,7 +11,9 @@ SH1106::SH1106(i2c_inst* i2CInst, uint8_t Address, Size size)
     : OLED::OLED(i2CInst, Address, Type::SH1106, size)
 {
     // create a frame buffer
-    this->frameBuffer = std::make_unique<FrameBuffer>(SH1106_FULL_BUFFER);
+    this->frameBuffer = std::make_unique<FrameBuffer>(SH1106_MAX_WIDTH, SH1106_MAX_HEIGHT);
+    this->bufferWidth = SH1106_MAX_WIDTH;
+    this->bufferHeight = SH1106_MAX_HEIGHT;
 
     // this is a list of setup commands for the display
     uint8_t setup[] = {
@@ -75,29 +77,17 @@ bool SH1106::IsConnected() {
     return true;
 }
 
-void SH1106::setPixel(const uint8_t x, const uint8_t y, const WriteMode mode)
+void SH1106::sendBuffer()
 {
-    // return if position out of bounds
-    if (x >= this->width|| y >= this->height)
-        return;
-
-    // byte to be used for buffer operation
-    auto byte = static_cast<uint8_t>(1U << (y & 7));
-
-    // check the write mode and manipulate the frame buffer
-    if (mode == WriteMode::ADD) {
-        this->frameBuffer->byteOR(x + (y >> 3) * SH1106_MAX_WIDTH, byte);
-    } else if (mode == WriteMode::SUBTRACT) {
-        this->frameBuffer->byteAND(x + (y >> 3) * SH1106_MAX_WIDTH, ~byte);
-    } else if (mode == WriteMode::INVERT) {
-        this->frameBuffer->byteXOR(x + (y >> 3) * SH1106_MAX_WIDTH, byte);
-    }
+    this->sendPages(0xFF);
 }
 
-void SH1106::sendBuffer()
+void SH1106::sendPages(uint8_t pageMask)
 {
-    const size_t pageCount = (this->height / 8);
-    uint8_t pageBuffer[SH1106_PAGE_SIZE + 1];
+    const size_t pageCount = ((this->portrait ? this->width : this->height) / 8);
+    // startline command is placed so that page data starts on a word boundary, which lets layers be composited 32 bits at a time
+    alignas(4) uint8_t storage[SH1106_PAGE_SIZE + 4];
+    uint8_t* pageBuffer = storage + 3;
     unsigned char displayShift = 2;
 
     this->cmd(SH1106_LOWCOLUMN | displayShift);
@@ -105,13 +95,22 @@ void SH1106::sendBuffer()
     this->cmd(SH1106_READ_MOD_WRITE);
     pageBuffer[0] = SH1106_STARTLINE;
     for (size_t currPage = 0; currPage < pageCount; currPage++) {
+        // a full page write wraps the column address back to where it started, so pages can be skipped freely
+        if (!((pageMask >> currPage) & 1))
+            continue;
         this->cmd(static_cast<uint8_t>(SH1106_PAGEADDR | currPage));
-        memcpy(pageBuffer + 1, frameBuffer->get() + (SH1106_PAGE_SIZE * currPage), SH1106_PAGE_SIZE);
+        this->renderPage(pageBuffer + 1, currPage);
         i2c_write_timeout_us(this->i2CInst, this->address, pageBuffer, SH1106_PAGE_SIZE + 1, false, 50000);
     }
     this->cmd(SH1106_END_WRITE);
 }
 
+void SH1106::setClockDivider(uint8_t value)
+{
+    this->cmd(SH1106_DISPLAYCLOCKDIV);
+    this->cmd(value);
+}
+
 void SH1106::setOrientation(bool orientation)
 {
     // remap columns and rows scan direction, effectively flipping the image on display
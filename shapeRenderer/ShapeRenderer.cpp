@@ -1,80 +1,741 @@
 #include "ShapeRenderer.h"
 
-void pico_oled::drawLine(pico_oled::OLED* oled, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, pico_oled::WriteMode mode)
-{
-    int x, y, dx, dy, dx0, dy0, px, py, xe, ye, i;
-    dx = x1 - x0;
-    dy = y1 - y0;
-    dx0 = fabs(dx);
-    dy0 = fabs(dy);
-    px = 2 * dy0 - dx0;
-    py = 2 * dx0 - dy0;
-    if (dy0 <= dx0) {
-        if (dx >= 0) {
-            x = x0;
-            y = y0;
-            xe = x1;
-        } else {
-            x = x1;
-            y = y1;
-            xe = x0;
-        }
-        oled->setPixel(x, y, mode);
-        for (i = 0; x < xe; i++) {
-            x = x + 1;
-            if (px < 0) {
-                px = px + 2 * dy0;
+#include <cstdlib>
+
+namespace {
+
+// calls span(d, half) for d from 0 to ra, half being the largest offset along the other axis that is still inside
+// the ellipse with radius ra along d and rb along half, or -1 if there is none.
+// Pixel centers are tested against an ellipse half a pixel bigger than the radii, which is the midpoint criterion:
+// 4 d^2 b^2 + 4 half^2 a^2 <= a^2 b^2 with a = 2 ra + 1, b = 2 rb + 1. Only integer math is used and half only
+// ever decreases, so the whole profile takes ra + rb steps
+template <typename Span>
+void ellipseProfile(int16_t ra, int16_t rb, Span span)
+{
+    const int64_t a2 = (2 * ra + 1) * (2 * ra + 1);
+    const int64_t b2 = (2 * rb + 1) * (2 * rb + 1);
+    const int64_t limit = a2 * b2;
+    int16_t half = rb;
+    for (int16_t d = 0; d <= ra; d++) {
+        while (half >= 0 && 4 * (d * d * b2 + half * half * a2) > limit)
+            half--;
+        span(d, half);
+    }
+}
+
+// calls box(x0, y0, x1, y1) for the outline of a rounded box, ex. an ellipse, as single row or column spans with
+// x0 <= x1 and y0 <= y1. Spans are worked out in 32 bits, as they can reach past int16_t range near its ends. Corners are quarters of an ellipse with radii rx, ry, centered at left, top and right, bottom
+// and joined by straight lines. Outline holds the pixels of the filled box whose neighbour above, below or to the side
+// lies outside of it, so no pixel is reported twice. Pixels of the octants around the horizontal axis, where
+// dy * rx < dx * ry, are reported as columns, the rest as rows, so every span is as long as possible
+template <typename Box>
+void roundOutline(int32_t left, int32_t top, int32_t right, int32_t bottom, int16_t rx, int16_t ry, Box box)
+{
+    int16_t halves[256 + 1];
+
+    // rows, half width at every dy from the corner centers
+    ellipseProfile(ry, rx, [&](int16_t dy, int16_t half) { halves[dy] = half; });
+    for (int16_t dy = 0; dy <= ry; dy++) {
+        // pixels up to inner have a filled neighbour on every side, pixels past outer belong to columns
+        const int16_t inner = std::min<int16_t>(halves[dy] - 1, dy < ry ? halves[dy + 1] : -1);
+        const int16_t outer = ry == 0 ? halves[dy] : std::min<int32_t>(halves[dy], dy * rx / ry);
+        if (outer <= inner)
+            continue;
+        for (int32_t y : { top - dy, bottom + dy }) {
+            if (inner < 0) {
+                box(left - outer, y, right + outer, y);
             } else {
-                if ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) {
-                    y = y + 1;
-                } else {
-                    y = y - 1;
-                }
-                px = px + 2 * (dy0 - dx0);
+                box(left - outer, y, left - inner - 1, y);
+                box(right + inner + 1, y, right + outer, y);
             }
-            oled->setPixel(x, y, mode);
+            if (dy == 0 && top == bottom)
+                break;
         }
-    } else {
-        if (dy >= 0) {
-            x = x0;
-            y = y0;
-            ye = y1;
-        } else {
-            x = x1;
-            y = y1;
-            ye = y0;
-        }
-        oled->setPixel(x, y, mode);
-        for (i = 0; y < ye; i++) {
-            y = y + 1;
-            if (py <= 0) {
-                py = py + 2 * dx0;
+    }
+
+    // columns, half height at every dx from the corner centers. Straight sides are the inner part of outermost columns
+    ellipseProfile(rx, ry, [&](int16_t dx, int16_t half) { halves[dx] = half; });
+    for (int16_t dx = 0; dx <= rx; dx++) {
+        const int16_t inner = std::min<int16_t>(halves[dx] - 1, dx < rx ? halves[dx + 1] : -1);
+        const int16_t outer = std::min<int32_t>(halves[dx], dx * ry == 0 ? -1 : (dx * ry - 1) / rx);
+        if (outer <= inner)
+            continue;
+        for (int32_t x : { left - dx, right + dx }) {
+            if (inner < 0) {
+                box(x, top - outer, x, bottom + outer);
             } else {
-                if ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) {
-                    x = x + 1;
-                } else {
-                    x = x - 1;
-                }
-                py = py + 2 * (dx0 - dy0);
+                box(x, top - outer, x, top - inner - 1);
+                box(x, bottom + inner + 1, x, bottom + outer);
+            }
+            if (dx == 0 && left == right)
+                break;
+        }
+    }
+
+    // without corners straight sides are left to report
+    if (rx == 0 && bottom - top > 1) {
+        box(left, top + 1, left, bottom - 1);
+        if (right != left)
+            box(right, top + 1, right, bottom - 1);
+    }
+}
+
+// clips box from x0, y0 to x1, y1 given in 32 bits against the clip rectangle, so it fits int16_t, and fills it.
+// pattern is an 8x8 fill pattern, nullptr for solid fill
+void fillBox(pico_oled::Canvas* canvas, int32_t x0, int32_t y0, int32_t x1, int32_t y1, const uint8_t* pattern,
+    pico_oled::WriteMode mode)
+{
+    int16_t left, top, right, bottom;
+    canvas->GetClipRect(left, top, right, bottom);
+    x0 = std::max<int32_t>(x0, left);
+    y0 = std::max<int32_t>(y0, top);
+    x1 = std::min<int32_t>(x1, right - 1);
+    y1 = std::min<int32_t>(y1, bottom - 1);
+    if (x0 <= x1 && y0 <= y1)
+        canvas->fillRegion(x0, y0, x1 - x0 + 1, y1 - y0 + 1, pattern, mode);
+}
+
+// fills a rounded box, see roundOutline, as vertical spans, every page of a column being a single masked byte.
+// pattern is an 8x8 fill pattern, nullptr for solid fill
+void roundFill(pico_oled::Canvas* canvas, int32_t left, int32_t top, int32_t right, int32_t bottom, int16_t rx, int16_t ry,
+    const uint8_t* pattern, pico_oled::WriteMode mode)
+{
+    ellipseProfile(rx, ry, [&](int16_t dx, int16_t half) {
+        if (dx == 0) {
+            fillBox(canvas, left, top - half, right, bottom + half, pattern, mode);
+            return;
+        }
+        fillBox(canvas, left - dx, top - half, left - dx, bottom + half, pattern, mode);
+        fillBox(canvas, right + dx, top - half, right + dx, bottom + half, pattern, mode);
+    });
+}
+
+// sin of 0 up to 90 degrees in 1 / 16384 units
+constexpr int16_t SINE_TABLE[91] = { 0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563, 2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334, 5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943, 8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311, 10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365, 12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044, 14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296, 15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083, 16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382, 16384 };
+
+// sin of any angle in degrees, in 1 / 16384 units
+int32_t sine(int32_t degrees)
+{
+    degrees %= 360;
+    if (degrees < 0)
+        degrees += 360;
+    if (degrees > 180)
+        return -sine(degrees - 180);
+    return SINE_TABLE[degrees <= 90 ? degrees : 180 - degrees];
+}
+
+// cos of any angle in degrees, in 1 / 16384 units
+int32_t cosine(int32_t degrees)
+{
+    return sine(degrees + 90);
+}
+
+// vertex in sub pixel units, see scanPolygon
+struct SubPoint {
+    int32_t x;
+    int32_t y;
+};
+
+// polygon edge in the active edge table. x is the first sub pixel position at or right of where the edge crosses the
+// current scanline, tracked as x - remainder / dy with 0 <= remainder < dy, so it is stepped with integer math only
+struct Edge {
+    int16_t yStart;
+    int16_t yEnd;
+    int32_t x;
+    int32_t remainder;
+    int32_t stepX;
+    int32_t stepRemainder;
+    int32_t dy;
+    int8_t winding;
+
+    inline void advance()
+    {
+        this->x += this->stepX;
+        this->remainder -= this->stepRemainder;
+        if (this->remainder < 0) {
+            this->x++;
+            this->remainder += this->dy;
+        }
+    }
+};
+
+// fills polygon with count vertices returned by vertex(i), their coordinates having shift bits of sub pixel precision,
+// with an 8x8 pattern or solid when pattern is nullptr.
+// Scanlines sample pixel centers, an edge covers the ones from its top end up to but without its bottom end, and a
+// span covers pixels from the first one at or right of an edge up to but without the first one at or right of the next
+template <typename Vertex>
+void scanPolygon(pico_oled::Canvas* canvas, uint8_t count, uint8_t shift, Vertex vertex, const uint8_t* pattern,
+    pico_oled::WriteMode mode, pico_oled::FillRule rule)
+{
+    const int32_t one = 1 << shift;
+    // first pixel at or after a sub pixel position
+    auto pixel = [=](int32_t position) { return (position + one - 1) >> shift; };
+
+    // only scanlines and columns inside of the clip rectangle are worked on
+    int16_t clipLeft, clipTop, clipRight, clipBottom;
+    canvas->GetClipRect(clipLeft, clipTop, clipRight, clipBottom);
+
+    // edge table, edges crossing no scanline are left out
+    Edge edges[pico_oled::MAX_POLYGON_POINTS];
+    uint8_t edgeCount = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        SubPoint top = vertex(i);
+        SubPoint bottom = vertex((i + 1) % count);
+        int8_t winding = 1;
+        if (top.y > bottom.y) {
+            std::swap(top, bottom);
+            winding = -1;
+        }
+        const int32_t yStart = std::max<int32_t>(pixel(top.y), clipTop);
+        const int32_t yEnd = std::min<int32_t>(pixel(bottom.y), clipBottom);
+        if (yStart >= yEnd)
+            continue;
+
+        Edge& edge = edges[edgeCount];
+        edge.yStart = yStart;
+        edge.yEnd = yEnd;
+        edge.dy = bottom.y - top.y;
+        // x moves by dx * one / dy every scanline, split with floor division so remainders are never negative
+        const int64_t dx = bottom.x - top.x;
+        edge.stepX = static_cast<int32_t>(dx * one / edge.dy);
+        edge.stepRemainder = static_cast<int32_t>(dx * one % edge.dy);
+        if (edge.stepRemainder < 0) {
+            edge.stepX--;
+            edge.stepRemainder += edge.dy;
+        }
+        // x at the first scanline is top.x + dx * (yStart * one - top.y) / dy
+        const int64_t skipped = dx * (static_cast<int64_t>(yStart) * one - top.y);
+        int64_t quotient = skipped / edge.dy;
+        int64_t remainder = skipped % edge.dy;
+        if (remainder < 0) {
+            quotient--;
+            remainder += edge.dy;
+        }
+        edge.x = top.x + static_cast<int32_t>(quotient) + (remainder > 0);
+        edge.remainder = remainder > 0 ? static_cast<int32_t>(edge.dy - remainder) : 0;
+        edge.winding = winding;
+
+        // keep edge table sorted by the first scanline
+        for (uint8_t j = edgeCount++; j > 0 && edges[j - 1].yStart > yStart; j--)
+            std::swap(edges[j], edges[j - 1]);
+    }
+    if (edgeCount == 0)
+        return;
+
+    // active edge table holds indices of edges crossing current scanline, sorted by x
+    uint8_t active[pico_oled::MAX_POLYGON_POINTS];
+    uint8_t activeCount = 0;
+    uint8_t nextEdge = 0;
+
+    for (int16_t y = edges[0].yStart; y < clipBottom; y++) {
+        while (nextEdge < edgeCount && edges[nextEdge].yStart == y)
+            active[activeCount++] = nextEdge++;
+        if (activeCount == 0 && nextEdge == edgeCount)
+            break;
+
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < activeCount; i++) {
+            if (edges[active[i]].yEnd > y)
+                active[kept++] = active[i];
+        }
+        activeCount = kept;
+
+        // edges keep their order between scanlines unless they cross, so insertion sort does little work
+        for (uint8_t i = 1; i < activeCount; i++) {
+            for (uint8_t j = i; j > 0 && edges[active[j - 1]].x > edges[active[j]].x; j--)
+                std::swap(active[j], active[j - 1]);
+        }
+
+        int16_t winding = 0;
+        int32_t spanStart = 0;
+        for (uint8_t i = 0; i < activeCount; i++) {
+            const Edge& edge = edges[active[i]];
+            const bool wasInside = winding != 0;
+            if (rule == pico_oled::FillRule::EVEN_ODD)
+                winding ^= 1;
+            else
+                winding += edge.winding;
+            const bool inside = winding != 0;
+
+            if (!wasInside && inside) {
+                spanStart = std::max<int32_t>(pixel(edge.x), clipLeft);
+            } else if (wasInside && !inside) {
+                const int32_t spanEnd = std::min<int32_t>(pixel(edge.x), clipRight);
+                if (spanEnd > spanStart)
+                    canvas->fillRegion(spanStart, y, spanEnd - spanStart, 1, pattern, mode);
+            }
+        }
+
+        for (uint8_t i = 0; i < activeCount; i++)
+            edges[active[i]].advance();
+    }
+}
+
+// integer square root, rounded down
+uint32_t isqrt(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value)
+        bit >>= 2;
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(root);
+}
+
+// sub pixel bits of thick line outlines
+constexpr uint8_t STROKE_SHIFT = 4;
+
+// fills outline of a line of width > 1 with given caps at its start and end
+void strokeLine(pico_oled::Canvas* canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t width,
+    pico_oled::LineCap startCap, pico_oled::LineCap endCap, pico_oled::WriteMode mode)
+{
+    using pico_oled::LineCap;
+
+    // half of the width along the line, in sub pixels. n is the same vector turned by 90 degrees
+    const int64_t dx = x1 - x0;
+    const int64_t dy = y1 - y0;
+    // a point with butt caps has no area
+    if (dx == 0 && dy == 0 && startCap == LineCap::BUTT && endCap == LineCap::BUTT)
+        return;
+    const int64_t length = isqrt((dx * dx + dy * dy) << (2 * STROKE_SHIFT));
+    const int64_t scaled = static_cast<int64_t>(width) << (2 * STROKE_SHIFT - 1);
+    auto roundDiv = [](int64_t a, int64_t b) { return (2 * a + (a < 0 ? -b : b)) / (2 * b); };
+    const int32_t ox = length == 0 ? scaled >> STROKE_SHIFT : roundDiv(dx * scaled, length);
+    const int32_t oy = length == 0 ? 0 : roundDiv(dy * scaled, length);
+    const int32_t nx = -oy;
+    const int32_t ny = ox;
+
+    SubPoint outline[26];
+    uint8_t count = 0;
+    // adds end of the line at x, y, going around it from +n to -n, o pointing away from the line
+    auto addEnd = [&](int32_t x, int32_t y, int32_t ox, int32_t oy, int32_t nx, int32_t ny, LineCap cap) {
+        x *= 1 << STROKE_SHIFT;
+        y *= 1 << STROKE_SHIFT;
+        if (cap == LineCap::ROUND) {
+            // half of a 24 sided polygon
+            for (uint8_t k = 0; k <= 12; k++) {
+                const int32_t c = cosine(15 * k);
+                const int32_t s = sine(15 * k);
+                outline[count++] = { x + ((nx * c + ox * s) >> 14), y + ((ny * c + oy * s) >> 14) };
+            }
+            return;
+        }
+        // butt ends are pushed out by a single sub pixel, so end pixels lying on them are drawn like with drawLine
+        const int32_t ex = cap == LineCap::SQUARE ? ox : (ox > 0) - (ox < 0);
+        const int32_t ey = cap == LineCap::SQUARE ? oy : (oy > 0) - (oy < 0);
+        outline[count++] = { x + ex + nx, y + ey + ny };
+        outline[count++] = { x + ex - nx, y + ey - ny };
+    };
+    addEnd(x1, y1, ox, oy, nx, ny, endCap);
+    addEnd(x0, y0, -ox, -oy, -nx, -ny, startCap);
+
+    scanPolygon(canvas, count, STROKE_SHIFT, [&outline](uint8_t i) { return outline[i]; }, nullptr, mode, pico_oled::FillRule::EVEN_ODD);
+}
+
+// fractional bits of curve coordinates, see bezierCurve
+constexpr uint8_t CURVE_SHIFT = 32;
+// curve parameter runs from 0 to 1 << CURVE_DEPTH, a single step being at least 1, so at most that many segments
+constexpr uint8_t CURVE_DEPTH = 8;
+// second difference of a step at which it is still drawn as a straight segment, in pixels. Segment of a curve strays
+// from its chord by at most an eighth of it, so a quarter of a pixel
+constexpr int64_t CURVE_FLATNESS = int64_t(2) << CURVE_SHIFT;
+
+// one coordinate of a curve point with its forward differences at the current step
+struct CurveAxis {
+    int64_t value;
+    int64_t first;
+    int64_t second;
+    int64_t third;
+
+    // coordinate with step h is a + b h + c h^2 + d h^3 of the curve parameter
+    CurveAxis(int32_t a, int32_t b, int32_t c, int32_t d)
+        : value(a * (int64_t(1) << CURVE_SHIFT))
+        , first((int64_t(b) + c + d) * (int64_t(1) << CURVE_SHIFT))
+        , second((2 * int64_t(c) + 6 * int64_t(d)) * (int64_t(1) << CURVE_SHIFT))
+        , third(6 * int64_t(d) * (int64_t(1) << CURVE_SHIFT))
+    {
+    }
+
+    // chord of the next step doesn't stray from the curve, second derivative being linear along it
+    inline bool flat() const
+    {
+        return std::abs(this->second) <= CURVE_FLATNESS && std::abs(this->second - this->third) <= CURVE_FLATNESS;
+    }
+
+    // the next two steps would be flat as a single one
+    inline bool flatDoubled() const
+    {
+        return 4 * std::abs(this->second + this->third) <= CURVE_FLATNESS && 4 * std::abs(this->second - this->third) <= CURVE_FLATNESS;
+    }
+
+    inline void halve()
+    {
+        this->first = (8 * this->first - 2 * this->second + this->third) >> 4;
+        this->second = (2 * this->second - this->third) >> 3;
+        this->third >>= 3;
+    }
+
+    inline void twice()
+    {
+        this->first = 2 * this->first + this->second;
+        this->second = 4 * (this->second + this->third);
+        this->third *= 8;
+    }
+
+    inline void step()
+    {
+        this->value += this->first;
+        this->first += this->second;
+        this->second += this->third;
+    }
+
+    inline int16_t pixel() const
+    {
+        return static_cast<int16_t>((this->value + (int64_t(1) << (CURVE_SHIFT - 1))) >> CURVE_SHIFT);
+    }
+};
+
+// draws cubic polynomial curve from x, y to endX, endY with adaptive forward differencing: the step is halved while its
+// chord would stray from the curve and doubled back where the curve gets straight, so flat parts take a few long
+// segments and sharp bends many short ones, all of them drawn with canvas->line. Steps are powers of two of the
+// parameter, so halving and doubling the differences keeps them exact up to the fractional bits
+void bezierCurve(pico_oled::Canvas* canvas, CurveAxis x, CurveAxis y, int16_t endX, int16_t endY, pico_oled::WriteMode mode)
+{
+    constexpr uint16_t end = 1 << CURVE_DEPTH;
+    uint16_t t = 0;
+    uint8_t depth = CURVE_DEPTH;
+    int16_t lastX = x.pixel();
+    int16_t lastY = y.pixel();
+    bool drawn = false;
+
+    while (t < end) {
+        while (depth > 0 && !(x.flat() && y.flat())) {
+            x.halve();
+            y.halve();
+            depth--;
+        }
+        while (depth < CURVE_DEPTH && ((t >> depth) & 1) == 0 && t + (2 << depth) <= end && x.flatDoubled() && y.flatDoubled()) {
+            x.twice();
+            y.twice();
+            depth++;
+        }
+        x.step();
+        y.step();
+        t += 1 << depth;
+
+        // last point is taken as given, so curves end exactly at their end points
+        const int16_t nextX = t == end ? endX : x.pixel();
+        const int16_t nextY = t == end ? endY : y.pixel();
+        if (nextX == lastX && nextY == lastY)
+            continue;
+        canvas->line(lastX, lastY, nextX, nextY, mode);
+        // segments share their ends, so in invert mode those are put back once
+        if (drawn && mode == pico_oled::WriteMode::INVERT)
+            canvas->setPixel(lastX, lastY, mode);
+        drawn = true;
+        lastX = nextX;
+        lastY = nextY;
+    }
+    // curve shrunk into a single pixel
+    if (!drawn)
+        canvas->line(lastX, lastY, lastX, lastY, mode);
+}
+
+}
+
+void pico_oled::drawLine(pico_oled::Canvas* canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, pico_oled::WriteMode mode)
+{
+    // spans for axis aligned lines, integer Bresenham on frame buffer bytes for the rest
+    canvas->line(x0, y0, x1, y1, mode);
+}
+
+void pico_oled::drawRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, pico_oled::WriteMode mode)
+{
+    if (x_start > x_end)
+        std::swap(x_start, x_end);
+    if (y_start > y_end)
+        std::swap(y_start, y_end);
+
+    canvas->hspan(x_start, x_end, y_start, mode);
+    if (y_end == y_start)
+        return;
+    canvas->hspan(x_start, x_end, y_end, mode);
+    // sides leave out the corners, so no pixel is touched twice in invert mode
+    if (y_end - y_start < 2)
+        return;
+    canvas->vspan(x_start, y_start + 1, y_end - 1, mode);
+    if (x_end != x_start)
+        canvas->vspan(x_end, y_start + 1, y_end - 1, mode);
+}
+
+void pico_oled::fillRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, pico_oled::WriteMode mode)
+{
+    pico_oled::fillRect(canvas, x_start, y_start, x_end, y_end, nullptr, mode);
+}
+
+void pico_oled::fillRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, const uint8_t* pattern,
+    pico_oled::WriteMode mode)
+{
+    if (x_start > x_end)
+        std::swap(x_start, x_end);
+    if (y_start > y_end)
+        std::swap(y_start, y_end);
+
+    // rectangle is intersected with the clip rectangle first, as its size might not fit int16_t
+    int16_t left, top, right, bottom;
+    canvas->GetClipRect(left, top, right, bottom);
+    x_start = std::max(x_start, left);
+    y_start = std::max(y_start, top);
+    x_end = std::min<int16_t>(x_end, right - 1);
+    y_end = std::min<int16_t>(y_end, bottom - 1);
+    if (x_start > x_end || y_start > y_end)
+        return;
+
+    // every covered page is a run of masked bytes, with whole 0xFF bytes for pages inside the rectangle
+    canvas->fillRegion(x_start, y_start, x_end - x_start + 1, y_end - y_start + 1, pattern, mode);
+}
+
+void pico_oled::drawCircle(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t radius, pico_oled::WriteMode mode)
+{
+    pico_oled::drawEllipse(canvas, x_center, y_center, radius, radius, mode);
+}
+
+void pico_oled::fillCircle(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t radius, pico_oled::WriteMode mode)
+{
+    roundFill(canvas, x_center, y_center, x_center, y_center, radius, radius, nullptr, mode);
+}
+
+void pico_oled::fillCircle(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t radius, const uint8_t* pattern,
+    pico_oled::WriteMode mode)
+{
+    roundFill(canvas, x_center, y_center, x_center, y_center, radius, radius, pattern, mode);
+}
+
+void pico_oled::drawEllipse(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t x_radius, uint8_t y_radius, pico_oled::WriteMode mode)
+{
+    roundOutline(x_center, y_center, x_center, y_center, x_radius, y_radius, [&](int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+        fillBox(canvas, x0, y0, x1, y1, nullptr, mode);
+    });
+}
+
+void pico_oled::fillEllipse(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t x_radius, uint8_t y_radius, pico_oled::WriteMode mode)
+{
+    roundFill(canvas, x_center, y_center, x_center, y_center, x_radius, y_radius, nullptr, mode);
+}
+
+void pico_oled::fillEllipse(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t x_radius, uint8_t y_radius,
+    const uint8_t* pattern, pico_oled::WriteMode mode)
+{
+    roundFill(canvas, x_center, y_center, x_center, y_center, x_radius, y_radius, pattern, mode);
+}
+
+void pico_oled::drawRoundRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, uint8_t radius,
+    pico_oled::WriteMode mode)
+{
+    if (x_start > x_end)
+        std::swap(x_start, x_end);
+    if (y_start > y_end)
+        std::swap(y_start, y_end);
+    // corners can take at most half of the rectangle
+    const int16_t r = std::min<int32_t>(radius, std::min(x_end - x_start, y_end - y_start) / 2);
+
+    roundOutline(x_start + r, y_start + r, x_end - r, y_end - r, r, r, [&](int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+        fillBox(canvas, x0, y0, x1, y1, nullptr, mode);
+    });
+}
+
+void pico_oled::fillRoundRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, uint8_t radius,
+    pico_oled::WriteMode mode)
+{
+    pico_oled::fillRoundRect(canvas, x_start, y_start, x_end, y_end, radius, nullptr, mode);
+}
+
+void pico_oled::fillRoundRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, uint8_t radius,
+    const uint8_t* pattern, pico_oled::WriteMode mode)
+{
+    if (x_start > x_end)
+        std::swap(x_start, x_end);
+    if (y_start > y_end)
+        std::swap(y_start, y_end);
+    const int16_t r = std::min<int32_t>(radius, std::min(x_end - x_start, y_end - y_start) / 2);
+
+    roundFill(canvas, x_start + r, y_start + r, x_end - r, y_end - r, r, r, pattern, mode);
+}
+
+void pico_oled::drawArc(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t radius, int16_t startAngle, int16_t endAngle,
+    pico_oled::WriteMode mode)
+{
+    // arc goes clockwise from start over sweep degrees, ends 360 degrees apart make a full circle
+    int32_t start = startAngle % 360;
+    if (start < 0)
+        start += 360;
+    int32_t sweep = (static_cast<int32_t>(endAngle) - startAngle) % 360;
+    if (sweep < 0)
+        sweep += 360;
+    if (sweep == 0 && endAngle != startAngle)
+        sweep = 360;
+
+    // octants of 45 degrees clockwise from 0, either completely inside or outside of the arc, or cut by its ends
+    enum class Octant : uint8_t { OUTSIDE, INSIDE, PARTIAL };
+    Octant octants[8];
+    for (uint8_t k = 0; k < 8; k++) {
+        const int32_t offset = (45 * k - start + 360) % 360;
+        if (offset + 45 <= sweep)
+            octants[k] = Octant::INSIDE;
+        else if (offset > sweep && offset + 45 < 360)
+            octants[k] = Octant::OUTSIDE;
+        else
+            octants[k] = Octant::PARTIAL;
+    }
+
+    // pixels of partial octants are tested against directions of the ends with cross products. y grows downwards, so
+    // a positive cross product means clockwise
+    const int32_t startX = cosine(start);
+    const int32_t startY = sine(start);
+    const int32_t endX = cosine(start + sweep);
+    const int32_t endY = sine(start + sweep);
+    auto octantOf = [](int32_t dx, int32_t dy) {
+        // rotate pixel into the first quadrant
+        uint8_t quadrant = 0;
+        while (!(dx > 0 && dy >= 0) && quadrant < 3) {
+            const int32_t t = dx;
+            dx = dy;
+            dy = -t;
+            quadrant++;
+        }
+        return static_cast<uint8_t>(2 * quadrant + (dy > dx ? 1 : 0));
+    };
+    auto onArc = [&](int32_t dx, int32_t dy) {
+        const Octant octant = octants[octantOf(dx, dy)];
+        if (octant != Octant::PARTIAL)
+            return octant == Octant::INSIDE;
+        const bool afterStart = startX * dy - startY * dx >= 0;
+        const bool beforeEnd = dx * endY - dy * endX >= 0;
+        if (sweep <= 180)
+            return afterStart && beforeEnd && (sweep != 0 || startX * dx + startY * dy >= 0);
+        return afterStart || beforeEnd;
+    };
+
+    // outline of the circle, see drawCircle, clipped and split into runs of pixels on the arc
+    int16_t left, top, right, bottom;
+    canvas->GetClipRect(left, top, right, bottom);
+    roundOutline(x_center, y_center, x_center, y_center, radius, radius, [&](int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+        x0 = std::max<int32_t>(x0, left);
+        y0 = std::max<int32_t>(y0, top);
+        x1 = std::min<int32_t>(x1, right - 1);
+        y1 = std::min<int32_t>(y1, bottom - 1);
+        if (x0 > x1 || y0 > y1)
+            return;
+        // octants are convex, so a span with both ends in the same one lies in it completely
+        const uint8_t octant = octantOf(x0 - x_center, y0 - y_center);
+        if (octants[octant] != Octant::PARTIAL && octant == octantOf(x1 - x_center, y1 - y_center)) {
+            if (octants[octant] == Octant::INSIDE)
+                canvas->fillRegion(x0, y0, x1 - x0 + 1, y1 - y0 + 1, mode);
+            return;
+        }
+
+        // spans are either a row or a column, walk them pixel by pixel
+        const bool row = y0 == y1;
+        const int32_t last = row ? x1 : y1;
+        bool inRun = false;
+        int32_t runStart = 0;
+        for (int32_t i = row ? x0 : y0; i <= last + 1; i++) {
+            const bool on = i <= last && (row ? onArc(i - x_center, y0 - y_center) : onArc(x0 - x_center, i - y_center));
+            if (on && !inRun) {
+                runStart = i;
+            } else if (!on && inRun) {
+                if (row)
+                    canvas->fillRegion(runStart, y0, i - runStart, 1, mode);
+                else
+                    canvas->fillRegion(x0, runStart, 1, i - runStart, mode);
             }
-            oled->setPixel(x, y, mode);
+            inRun = on;
         }
+    });
+}
+
+void pico_oled::drawPolygon(pico_oled::Canvas* canvas, const pico_oled::Point* points, uint8_t count, pico_oled::WriteMode mode)
+{
+    count = std::min(count, MAX_POLYGON_POINTS);
+    if (count == 0)
+        return;
+    if (count < 3) {
+        canvas->line(points[0].x, points[0].y, points[count - 1].x, points[count - 1].y, mode);
+        return;
     }
+
+    for (uint8_t i = 0; i < count; i++) {
+        const Point& from = points[i];
+        const Point& to = points[(i + 1) % count];
+        canvas->line(from.x, from.y, to.x, to.y, mode);
+        // every vertex ends two edges, so in invert mode it has been flipped back and needs one more flip
+        if (mode == WriteMode::INVERT && canvas->isVisible(to.x, to.y, 1, 1))
+            canvas->fillRegion(to.x, to.y, 1, 1, mode);
+    }
+}
+
+void pico_oled::fillPolygon(pico_oled::Canvas* canvas, const pico_oled::Point* points, uint8_t count, pico_oled::WriteMode mode,
+    pico_oled::FillRule rule)
+{
+    pico_oled::fillPolygon(canvas, points, count, nullptr, mode, rule);
 }
 
-void pico_oled::drawRect(pico_oled::OLED* oled, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, pico_oled::WriteMode mode)
+void pico_oled::fillPolygon(pico_oled::Canvas* canvas, const pico_oled::Point* points, uint8_t count, const uint8_t* pattern,
+    pico_oled::WriteMode mode, pico_oled::FillRule rule)
 {
-    drawLine(oled, x_start, y_start, x_end, y_start, mode);
-    drawLine(oled, x_start, y_end, x_end, y_end, mode);
-    drawLine(oled, x_start, y_start, x_start, y_end, mode);
-    drawLine(oled, x_end, y_start, x_end, y_end, mode);
+    count = std::min(count, MAX_POLYGON_POINTS);
+    scanPolygon(canvas, count, 0, [points](uint8_t i) { return SubPoint { points[i].x, points[i].y }; }, pattern, mode, rule);
 }
 
-void pico_oled::fillRect(pico_oled::OLED* oled, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, pico_oled::WriteMode mode)
+void pico_oled::drawThickLine(pico_oled::Canvas* canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t width, pico_oled::LineCap cap,
+    pico_oled::WriteMode mode)
 {
-    for (uint8_t x = x_start; x <= x_end; x++) {
-        for (uint8_t y = y_start; y <= y_end; y++) {
-            oled->setPixel(x, y, mode);
+    if (width == 0)
+        return;
+    if (width == 1) {
+        canvas->line(x0, y0, x1, y1, mode);
+        return;
+    }
+    strokeLine(canvas, x0, y0, x1, y1, width, cap, cap, mode);
+}
+
+void pico_oled::drawPolyline(pico_oled::Canvas* canvas, const pico_oled::Point* points, uint8_t count, uint8_t width, pico_oled::LineCap cap,
+    pico_oled::WriteMode mode)
+{
+    if (width == 0)
+        return;
+    for (uint8_t i = 0; i + 1 < count; i++) {
+        if (width == 1) {
+            canvas->line(points[i].x, points[i].y, points[i + 1].x, points[i + 1].y, mode);
+            continue;
         }
+        strokeLine(canvas, points[i].x, points[i].y, points[i + 1].x, points[i + 1].y, width,
+            i == 0 ? cap : LineCap::ROUND, i + 2 == count ? cap : LineCap::ROUND, mode);
     }
 }
+
+void pico_oled::drawQuadraticBezier(pico_oled::Canvas* canvas, int16_t x0, int16_t y0, int16_t cx, int16_t cy, int16_t x1, int16_t y1,
+    pico_oled::WriteMode mode)
+{
+    // B(t) = P0 + 2 (C - P0) t + (P0 - 2 C + P1) t^2
+    const CurveAxis x(x0, 2 * (cx - x0), x0 - 2 * cx + x1, 0);
+    const CurveAxis y(y0, 2 * (cy - y0), y0 - 2 * cy + y1, 0);
+    bezierCurve(canvas, x, y, x1, y1, mode);
+}
+
+void pico_oled::drawCubicBezier(pico_oled::Canvas* canvas, int16_t x0, int16_t y0, int16_t cx0, int16_t cy0, int16_t cx1, int16_t cy1,
+    int16_t x1, int16_t y1, pico_oled::WriteMode mode)
+{
+    // B(t) = P0 + 3 (C0 - P0) t + 3 (P0 - 2 C0 + C1) t^2 + (P1 - P0 + 3 (C0 - C1)) t^3
+    const CurveAxis x(x0, 3 * (cx0 - x0), 3 * (x0 - 2 * cx0 + cx1), x1 - x0 + 3 * (cx0 - cx1));
+    const CurveAxis y(y0, 3 * (cy0 - y0), 3 * (y0 - 2 * cy0 + cy1), y1 - y0 + 3 * (cy0 - cy1));
+    bezierCurve(canvas, x, y, x1, y1, mode);
+}
@@ -1,27 +1,196 @@
 #ifndef OLED_SHAPERENDERER_H
 #define OLED_SHAPERENDERER_H
 
-#include "../oled.hpp"
-#include <math.h>
+#include "../canvas.hpp"
+#include <algorithm>
+#include <utility>
 
 namespace pico_oled {
 
+/// \brief Vertex of a polygon, coordinates may lie outside of the canvas
+struct Point {
+    int16_t x;
+    int16_t y;
+};
+
+/// \enum pico_oled::FillRule
+enum class FillRule {
+    /// pixel is filled when a ray from it crosses the outline an odd number of times, so overlapping parts leave holes
+    EVEN_ODD,
+    /// pixel is filled when the outline winds around it, so self overlapping parts stay filled
+    NON_ZERO,
+};
+
+/// \enum pico_oled::LineCap
+enum class LineCap {
+    /// line ends right at its end points
+    BUTT,
+    /// line is extended past its end points by half of its width
+    SQUARE,
+    /// line ends with half a circle around its end points
+    ROUND,
+};
+
+/// Maximum amount of polygon points, further points are ignored
+constexpr uint8_t MAX_POLYGON_POINTS = 32;
+
 /// \brief Draws a line from x0, y0 to x1, y1.
 /// It supports all drawing angles
-/// \param oled - is the pointer to an OLED object aka an initialised display
+/// \param canvas - is the pointer to a Canvas object, either an initialised display or an off-screen canvas
+/// \param x0, y0, x1, y1 are the start and end coordinates between which the line will be drawn
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void drawLine(pico_oled::Canvas* canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Draws a line of given width from x0, y0 to x1, y1, ex. a graph or a gauge needle
+///
+/// Outline of the line is built from its ends, width and caps with sub pixel precision and filled as a single convex
+/// polygon, so every pixel is touched once
 /// \param x0, y0, x1, y1 are the start and end coordinates between which the line will be drawn
+/// \param width - width of the line in pixels, 1 px wide lines are the same as drawLine
+/// \param cap - shape of line ends, see LineCap
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void drawThickLine(pico_oled::Canvas* canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t width, LineCap cap = LineCap::BUTT,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Draws lines of given width through all points, joined with round caps
+///
+/// Every line is filled on its own, so in invert mode the joints are inverted twice
+/// \param points, count - points to connect, in order
+/// \param width - width of the lines in pixels
+/// \param cap - shape of the ends of the first and last line, see LineCap
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void drawPolyline(pico_oled::Canvas* canvas, const Point* points, uint8_t count, uint8_t width, LineCap cap = LineCap::ROUND,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Draws a 1px wide quadratic Bezier curve from x0, y0 to x1, y1, ex. a smooth trend line
+///
+/// Curve is walked in fixed point with adaptive forward differencing and drawn as straight segments, short ones
+/// in sharp bends and long ones where it is flat, no segment straying from the curve by more than a quarter of a pixel.
+/// In invert mode pixels the curve passes twice, ex. where it crosses itself or turns back, are inverted twice
+/// \param x0, y0, x1, y1 - start and end of the curve, which it passes through
+/// \param cx, cy - control point, which the curve bends towards
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void drawQuadraticBezier(pico_oled::Canvas* canvas, int16_t x0, int16_t y0, int16_t cx, int16_t cy, int16_t x1, int16_t y1,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Draws a 1px wide cubic Bezier curve from x0, y0 to x1, y1, see drawQuadraticBezier
+/// \param x0, y0, x1, y1 - start and end of the curve, which it passes through
+/// \param cx0, cy0 - control point of the start, curve leaves x0, y0 heading towards it
+/// \param cx1, cy1 - control point of the end, curve arrives at x1, y1 coming from its direction
 /// \param mode - mode describes setting behavior. See WriteMode doc for more information
-void drawLine(pico_oled::OLED* oled, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+void drawCubicBezier(pico_oled::Canvas* canvas, int16_t x0, int16_t y0, int16_t cx0, int16_t cy0, int16_t cx1, int16_t cy1,
+    int16_t x1, int16_t y1, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
 
 /// \brief Draws a 1px wide rectangle between x0, y0 and x1, y1
 /// \param x_start, x_end, y_start, y_end - corner points for the rectangle
 /// \param mode - mode describes setting behavior. See WriteMode doc for more information
-void drawRect(pico_oled::OLED* oled, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+void drawRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
 
 /// \brief Fills a rectangle from x0, y0 to x1, y1
 /// \param x_start, x_end, y_start, y_end - corner points for the rectangle
 /// \param mode - mode describes setting behavior. See WriteMode doc for more information
-void fillRect(pico_oled::OLED* oled, uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+void fillRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Fills a rectangle from x0, y0 to x1, y1 with an 8x8 pattern, ex. for a disabled widget
+/// \param x_start, x_end, y_start, y_end - corner points for the rectangle
+/// \param pattern - 8x8 pattern, one byte per column, ex. PATTERN_50. See Canvas::fillRegion
+/// \param mode - ADD sets pattern pixels, SUBTRACT clears them, INVERT inverts them and COPY replaces the shape with the pattern
+void fillRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, const uint8_t* pattern,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Draws a 1px wide rectangle with rounded corners, ex. a button
+/// \param x_start, x_end, y_start, y_end - corner points for the rectangle
+/// \param radius - radius of the corners, at most half of the shorter side is used
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void drawRoundRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, uint8_t radius,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Fills a rectangle with rounded corners
+/// \param x_start, x_end, y_start, y_end - corner points for the rectangle
+/// \param radius - radius of the corners, at most half of the shorter side is used
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void fillRoundRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, uint8_t radius,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Fills a rectangle with rounded corners with an 8x8 pattern
+/// \param x_start, x_end, y_start, y_end - corner points for the rectangle
+/// \param radius - radius of the corners, at most half of the shorter side is used
+/// \param pattern - 8x8 pattern, one byte per column, ex. PATTERN_50. See Canvas::fillRegion
+/// \param mode - ADD sets pattern pixels, SUBTRACT clears them, INVERT inverts them and COPY replaces the shape with the pattern
+void fillRoundRect(pico_oled::Canvas* canvas, int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, uint8_t radius,
+    const uint8_t* pattern, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Draws a 1px wide circle outline
+/// \param x_center, y_center - center of the circle
+/// \param radius - radius of the circle, the circle being 2 * radius + 1 px wide
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void drawCircle(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t radius, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Fills a circle, ex. a status LED
+/// \param x_center, y_center - center of the circle
+/// \param radius - radius of the circle, the circle being 2 * radius + 1 px wide
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void fillCircle(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t radius, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Fills a circle with an 8x8 pattern
+/// \param x_center, y_center - center of the circle
+/// \param radius - radius of the circle, the circle being 2 * radius + 1 px wide
+/// \param pattern - 8x8 pattern, one byte per column, ex. PATTERN_50. See Canvas::fillRegion
+/// \param mode - ADD sets pattern pixels, SUBTRACT clears them, INVERT inverts them and COPY replaces the shape with the pattern
+void fillCircle(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t radius, const uint8_t* pattern,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Draws part of a circle outline, ex. a progress ring. Pixels are the same as drawCircle ones
+/// \param x_center, y_center - center of the circle
+/// \param radius - radius of the circle
+/// \param startAngle, endAngle - ends of the arc in degrees, 0 pointing right and angles growing clockwise. Arc goes
+/// clockwise from startAngle to endAngle, so 0 to 90 is the bottom right quarter and 0 to 360 the whole circle
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void drawArc(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t radius, int16_t startAngle, int16_t endAngle,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Draws a 1px wide axis aligned ellipse outline
+/// \param x_center, y_center - center of the ellipse
+/// \param x_radius, y_radius - radii of the ellipse, the ellipse being 2 * x_radius + 1 px wide and 2 * y_radius + 1 px tall
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void drawEllipse(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t x_radius, uint8_t y_radius, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Fills an axis aligned ellipse
+/// \param x_center, y_center - center of the ellipse
+/// \param x_radius, y_radius - radii of the ellipse, the ellipse being 2 * x_radius + 1 px wide and 2 * y_radius + 1 px tall
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void fillEllipse(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t x_radius, uint8_t y_radius, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Fills an axis aligned ellipse with an 8x8 pattern
+/// \param x_center, y_center - center of the ellipse
+/// \param x_radius, y_radius - radii of the ellipse, the ellipse being 2 * x_radius + 1 px wide and 2 * y_radius + 1 px tall
+/// \param pattern - 8x8 pattern, one byte per column, ex. PATTERN_50. See Canvas::fillRegion
+/// \param mode - ADD sets pattern pixels, SUBTRACT clears them, INVERT inverts them and COPY replaces the shape with the pattern
+void fillEllipse(pico_oled::Canvas* canvas, int16_t x_center, int16_t y_center, uint8_t x_radius, uint8_t y_radius, const uint8_t* pattern,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Draws a 1px wide closed outline through all points, ex. an arrow or a gauge needle
+/// \param points, count - polygon vertices, at most MAX_POLYGON_POINTS are used, the last one is connected to the first one
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+void drawPolygon(pico_oled::Canvas* canvas, const Point* points, uint8_t count, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD);
+
+/// \brief Fills a polygon with an integer active edge table scanline fill, every scanline being emitted as spans
+///
+/// Pixels are filled when they lie inside of the outline, pixels exactly on right and bottom edges are left out,
+/// so polygons sharing an edge don't overlap. Drawing drawPolygon with the same points on top covers the edges
+/// \param points, count - polygon vertices, at most MAX_POLYGON_POINTS are used, the last one is connected to the first one
+/// \param mode - mode describes setting behavior. See WriteMode doc for more information
+/// \param rule - decides which parts of self intersecting polygons are filled, see FillRule
+void fillPolygon(pico_oled::Canvas* canvas, const Point* points, uint8_t count, pico_oled::WriteMode mode = pico_oled::WriteMode::ADD,
+    FillRule rule = FillRule::EVEN_ODD);
+
+/// \brief Fills a polygon with an 8x8 pattern, see fillPolygon
+/// \param points, count - polygon vertices, at most MAX_POLYGON_POINTS are used, the last one is connected to the first one
+/// \param pattern - 8x8 pattern, one byte per column, ex. PATTERN_50. See Canvas::fillRegion
+/// \param mode - ADD sets pattern pixels, SUBTRACT clears them, INVERT inverts them and COPY replaces the shape with the pattern
+/// \param rule - decides which parts of self intersecting polygons are filled, see FillRule
+void fillPolygon(pico_oled::Canvas* canvas, const Point* points, uint8_t count, const uint8_t* pattern,
+    pico_oled::WriteMode mode = pico_oled::WriteMode::ADD, FillRule rule = FillRule::EVEN_ODD);
 }
 
 #endif // OLED_SHAPERENDERER_H
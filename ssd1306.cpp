@@ -1,13 +1,21 @@
 #include "ssd1306.hpp"
 
-#define SSD1306_FULL_BUFFER 1024
+#define SSD1306_MAX_WIDTH (128)
+#define SSD1306_MAX_HEIGHT (64)
+#define SSD1306_FULL_BUFFER ((SSD1306_MAX_WIDTH * SSD1306_MAX_HEIGHT) >> 3)
 
 namespace pico_oled {
 SSD1306::SSD1306(i2c_inst* i2CInst, uint8_t Address, Size size)
     : OLED::OLED(i2CInst, Address, Type::SSD1306, size)
 {
     // create a frame buffer
-    this->frameBuffer = std::make_unique<FrameBuffer>(SSD1306_FULL_BUFFER);
+    // 32 px tall displays still use all 64 rows of the buffer, every display row taking up two of them
+    this->frameBuffer = std::make_unique<FrameBuffer>(SSD1306_MAX_WIDTH, SSD1306_MAX_HEIGHT);
+    this->bufferWidth = SSD1306_MAX_WIDTH;
+    this->bufferHeight = SSD1306_MAX_HEIGHT;
+    if (size == Size::W128xH32) {
+        this->rowScale = 2;
+    }
 
     // this is a list of setup commands for the display
     uint8_t setup[] = {
@@ -69,57 +77,54 @@ bool SSD1306::IsConnected() {
     return true;
 }
 
-void SSD1306::setPixel(const uint8_t x, const uint8_t y, const WriteMode mode)
+void SSD1306::sendBuffer()
 {
-    // return if position out of bounds
-    if (x >= this->width || y >= this->height)
-        return;
-
-    // byte to be used for buffer operation
-    uint8_t byte { 0x00 };
-    uint8_t workY { y };
-
-    // display with 32 px height requires doubling of set bits, reason to this is explained in readme
-    // this shifts 1 to byte based on y coordinate
-    // remember that buffer is a one dimension array, so we have to calculate offset from coordinates
-    if (size == Size::W128xH32) {
-        workY = static_cast<uint8_t>((workY << 1) + 1U);
-        byte = static_cast<uint8_t>(1U << (workY & 7));
-        uint8_t byte_offset = byte >> 1;
-        byte = byte | byte_offset;
-    } else {
-        byte = static_cast<uint8_t>(1U << (workY & 7));
-    }
-
-    // check the write mode and manipulate the frame buffer
-    if (mode == WriteMode::ADD) {
-        this->frameBuffer->byteOR(x + (workY / 8) * this->width, byte);
-    } else if (mode == WriteMode::SUBTRACT) {
-        this->frameBuffer->byteAND(x + (workY / 8) * this->width, ~byte);
-    } else if (mode == WriteMode::INVERT) {
-        this->frameBuffer->byteXOR(x + (workY / 8) * this->width, byte);
-    }
+    this->sendPages(0xFF);
 }
 
-void SSD1306::sendBuffer()
+void SSD1306::sendPages(uint8_t pageMask)
 {
-    this->cmd(SSD1306_PAGEADDR); // Set page address from min to max
-    this->cmd(0x00);
-    this->cmd(0x07);
-    this->cmd(SSD1306_COLUMNADDR); // Set column address from min to max
-    this->cmd(0x00);
-    this->cmd(127);
-
     // create a temporary buffer of size of buffer plus 1 byte for startline command aka 0x40
-    unsigned char data[SSD1306_FULL_BUFFER + 1];
-
-    data[0] = SSD1306_STARTLINE;
-
-    // copy framebuffer to temporary buffer
-    memcpy(data + 1, frameBuffer->get(), SSD1306_FULL_BUFFER);
+    // startline command is placed so that frame buffer data starts on a word boundary, which lets layers be composited 32 bits at a time
+    alignas(4) unsigned char storage[SSD1306_FULL_BUFFER + 4];
+    unsigned char* data = storage + 3;
+
+    // every run of neighbouring pages goes out as a single transfer
+    uint8_t page = 0;
+    while (page < SSD1306_MAX_HEIGHT / 8) {
+        if (!((pageMask >> page) & 1)) {
+            page++;
+            continue;
+        }
+        uint8_t last = page;
+        while (last + 1 < SSD1306_MAX_HEIGHT / 8 && ((pageMask >> (last + 1)) & 1))
+            last++;
+
+        this->cmd(SSD1306_PAGEADDR); // Set page address range of the run
+        this->cmd(page);
+        this->cmd(last);
+        this->cmd(SSD1306_COLUMNADDR); // Set column address from min to max
+        this->cmd(0x00);
+        this->cmd(127);
+
+        data[0] = SSD1306_STARTLINE;
+
+        // copy framebuffer with layers composited over it to temporary buffer, page by page
+        const size_t size = (last - page + 1) * SSD1306_MAX_WIDTH;
+        for (uint8_t p = page; p <= last; p++) {
+            this->renderPage(data + 1 + (p - page) * SSD1306_MAX_WIDTH, p);
+        }
+
+        // send data to device
+        i2c_write_timeout_us(this->i2CInst, this->address, data, size + 1, false, 50000);
+        page = last + 1;
+    }
+}
 
-    // send data to device
-    i2c_write_timeout_us(this->i2CInst, this->address, data, SSD1306_FULL_BUFFER + 1, false, 50000);
+void SSD1306::setClockDivider(uint8_t value)
+{
+    this->cmd(SSD1306_DISPLAYCLOCKDIV);
+    this->cmd(value);
 }
 
 void SSD1306::setOrientation(bool orientation)
@@ -54,8 +54,9 @@ public:
     SSD1306(i2c_inst* i2CInst, uint8_t Address, Size size);
 
     bool IsConnected() final;
-    void setPixel(const uint8_t x, const uint8_t y, const WriteMode mode) final;
     void sendBuffer() final;
+    void sendPages(uint8_t pageMask) final;
+    void setClockDivider(uint8_t value) final;
     void setOrientation(bool orientation) final;
     void invertDisplay() final;
     void setContrast(const uint8_t contrast) final;
@@ -2,7 +2,7 @@
 
 namespace pico_oled {
 
-void drawText(pico_oled::OLED* oled, const unsigned char* font, const char* text, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode, Rotation rotation)
+void drawText(pico_oled::Canvas* canvas, const unsigned char* font, const char* text, int16_t anchor_x, int16_t anchor_y, WriteMode mode, Rotation rotation)
 {
     uint8_t font_width = font[0];
 
@@ -10,10 +10,10 @@ void drawText(pico_oled::OLED* oled, const unsigned char* font, const char* text
     while (text[n] != '\0') {
         switch (rotation) {
         case Rotation::deg0:
-            drawChar(oled, font, text[n], anchor_x + (n * font_width), anchor_y, mode, rotation);
+            drawChar(canvas, font, text[n], anchor_x + (n * font_width), anchor_y, mode, rotation);
             break;
         case Rotation::deg90:
-            drawChar(oled, font, text[n], anchor_x, anchor_y + (n * font_width), mode, rotation);
+            drawChar(canvas, font, text[n], anchor_x, anchor_y + (n * font_width), mode, rotation);
             break;
         }
 
@@ -21,7 +21,7 @@ void drawText(pico_oled::OLED* oled, const unsigned char* font, const char* text
     }
 }
 
-void drawChar(pico_oled::OLED* oled, const unsigned char* font, char c, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode, Rotation rotation)
+void drawChar(pico_oled::Canvas* canvas, const unsigned char* font, char c, int16_t anchor_x, int16_t anchor_y, WriteMode mode, Rotation rotation)
 {
     if (c < 32)
         return;
@@ -29,21 +29,46 @@ void drawChar(pico_oled::OLED* oled, const unsigned char* font, char c, uint8_t
     uint8_t font_width = font[0];
     uint8_t font_height = font[1];
 
-    uint16_t seek = (c - 32) * (font_width * font_height) / 8 + 2;
+    // glyphs outside of the viewport are skipped as a whole
+    if (rotation == Rotation::deg0 && !canvas->isVisible(anchor_x, anchor_y, font_width, font_height))
+        return;
+    if (rotation == Rotation::deg90 && !canvas->isVisible(anchor_x, anchor_y, font_height + 1, font_width))
+        return;
+
+    // only glyph columns inside of the clip rectangle are decoded, with deg90 rotation they end up as rows
+    int16_t left, top, right, bottom;
+    canvas->GetClipRect(left, top, right, bottom);
+    const int16_t origin = rotation == Rotation::deg0 ? anchor_x : anchor_y;
+    const uint8_t x_first = std::max<int32_t>(0, (rotation == Rotation::deg0 ? left : top) - origin);
+    const uint8_t x_last = std::min<int32_t>(font_width, (rotation == Rotation::deg0 ? right : bottom) - origin);
 
-    uint8_t b_seek = 0;
+    // glyph bits are column after column, font_height bits each
+    const uint16_t first_bit = x_first * font_height;
+    uint16_t seek = (c - 32) * (font_width * font_height) / 8 + 2 + first_bit / 8;
+
+    uint8_t b_seek = first_bit % 8;
+
+    // draws a run of set bits from glyph column x as a single span, which is clipped by the canvas
+    auto drawRun = [&](uint8_t x, uint8_t y_first, uint8_t y_last) {
+        switch (rotation) {
+        case Rotation::deg0:
+            canvas->vspan(x + anchor_x, y_first + anchor_y, y_last + anchor_y, mode);
+            break;
+        case Rotation::deg90:
+            canvas->hspan(anchor_x + font_height - y_last, anchor_x + font_height - y_first, x + anchor_y, mode);
+            break;
+        }
+    };
 
-    for (uint8_t x = 0; x < font_width; x++) {
+    for (uint8_t x = x_first; x < x_last; x++) {
+        int16_t run_start = -1;
         for (uint8_t y = 0; y < font_height; y++) {
             if (font[seek] >> b_seek & 0b00000001) {
-                switch (rotation) {
-                case Rotation::deg0:
-                    oled->setPixel(x + anchor_x, y + anchor_y, mode);
-                    break;
-                case Rotation::deg90:
-                    oled->setPixel(-y + anchor_x + font_height, x + anchor_y, mode);
-                    break;
-                }
+                if (run_start < 0)
+                    run_start = y;
+            } else if (run_start >= 0) {
+                drawRun(x, run_start, y - 1);
+                run_start = -1;
             }
             b_seek++;
             if (b_seek == 8) {
@@ -51,6 +76,8 @@ void drawChar(pico_oled::OLED* oled, const unsigned char* font, char c, uint8_t
                 seek++;
             }
         }
+        if (run_start >= 0)
+            drawRun(x, run_start, font_height - 1);
     }
 }
-}
\ No newline at end of file
+}
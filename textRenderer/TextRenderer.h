@@ -1,7 +1,7 @@
 #ifndef OLED_TEXTRENDERER_H
 #define OLED_TEXTRENDERER_H
 
-#include "../oled.hpp"
+#include "../canvas.hpp"
 
 #include "12x16_font.h"
 #include "16x32_font.h"
@@ -19,22 +19,22 @@ enum class Rotation {
 };
 
 /// \brief Draws a single glyph on the screen
-/// \param oled - pointer to an OLED object aka initialised display
+/// \param canvas - pointer to a Canvas object, either an initialised display or an off-screen canvas
 /// \param font - pointer to a font data array
 /// \param c - char to be drawn
-/// \param anchor_x, anchor_y - coordinates setting where to put the glyph
+/// \param anchor_x, anchor_y - coordinates setting where to put the glyph, it may lie partially or fully outside of the canvas
 /// \param mode - mode describes setting behavior. See WriteMode doc for more information
 /// \param rotation - either rotates the char by 90 deg or leaves it unrotated
-void drawChar(pico_oled::OLED* oled, const unsigned char* font, char c, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0);
+void drawChar(pico_oled::Canvas* canvas, const unsigned char* font, char c, int16_t anchor_x, int16_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0);
 
 /// \brief Draws text on screen
-/// \param oled - pointer to a OLED object aka initialised display
+/// \param canvas - pointer to a Canvas object, either an initialised display or an off-screen canvas
 /// \param font - pointer to a font data array
 /// \param text - text to be drawn
-/// \param anchor_x, anchor_y - coordinates setting where to put the text
+/// \param anchor_x, anchor_y - coordinates setting where to put the text, it may lie partially or fully outside of the canvas
 /// \param mode - mode describes setting behavior. See WriteMode doc for more information
 /// \param rotation - either rotates the text by 90 deg or leaves it unrotated
-void drawText(pico_oled::OLED* oled, const unsigned char* font, const char* text, uint8_t anchor_x, uint8_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0);
+void drawText(pico_oled::Canvas* canvas, const unsigned char* font, const char* text, int16_t anchor_x, int16_t anchor_y, WriteMode mode = WriteMode::ADD, Rotation rotation = Rotation::deg0);
 }
 
 #endif // OLED_TEXTRENDERER_H
@@ -0,0 +1,20 @@
+#ifndef BENCH_BENCH_H
+#define BENCH_BENCH_H
+
+#include <chrono>
+#include <cstdio>
+
+/// \brief Runs f runs times and returns the average time of a single run in microseconds
+template <typename F>
+double measure(int runs, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        f();
+        // keeps the compiler from dropping or merging runs whose result is never read
+        asm volatile("" ::: "memory");
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / runs;
+}
+
+#endif // BENCH_BENCH_H
@@ -0,0 +1,70 @@
+// addBitmapImage: per pixel setPixel path it replaced against the 8x8 transpose path
+#include "bench.h"
+#include "ssd1306.hpp"
+#include <cstdlib>
+#include <cstring>
+
+using namespace pico_oled;
+
+// addBitmapImage before the transpose kernel: every set bit of the image goes through setPixel
+static void perPixelBitmap(Canvas& canvas, int16_t anchorX, int16_t anchorY, uint8_t imageWidth, uint8_t imageHeight, const uint8_t* image,
+    WriteMode mode)
+{
+    for (uint8_t y = 0; y < imageHeight; y++) {
+        for (uint8_t x = 0; x < imageWidth / 8; x++) {
+            const uint8_t byte = image[y * (imageWidth / 8) + x];
+            for (uint8_t z = 0; z < 8; z++) {
+                if ((byte >> (7 - z)) & 1) {
+                    const int16_t xCoord = x * 8 + z + anchorX;
+                    const int16_t yCoord = y + anchorY;
+                    if (xCoord >= 0 && xCoord < canvas.GetWidth() && yCoord >= 0 && yCoord < canvas.GetHeight())
+                        canvas.setPixel(xCoord, yCoord, mode);
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    i2c_inst i2c;
+    SSD1306 display(&i2c, 0x3C, Size::W128xH64);
+    SSD1306 check(&i2c, 0x3C, Size::W128xH64);
+
+    // half of the pixels set, so both paths have the same work as for a busy screen
+    uint8_t screen[128 / 8 * 64];
+    uint8_t icon[16 / 8 * 16];
+    srand(30);
+    for (uint8_t& byte : screen)
+        byte = static_cast<uint8_t>(rand());
+    for (uint8_t& byte : icon)
+        byte = static_cast<uint8_t>(rand());
+
+    struct Case {
+        const char* name;
+        int16_t x, y;
+        uint8_t w, h;
+        const uint8_t* image;
+        int runs;
+    };
+    const Case cases[] = {
+        { "128x64 image", 0, 0, 128, 64, screen, 20000 },
+        { "16x16 icon at 37,21", 37, 21, 16, 16, icon, 200000 },
+    };
+
+    printf("addBitmapImage, ADD mode          per pixel   transpose\n");
+    for (const Case& c : cases) {
+        const double perPixel = measure(c.runs, [&] { perPixelBitmap(display, c.x, c.y, c.w, c.h, c.image, WriteMode::ADD); });
+        const double transpose = measure(c.runs, [&] { display.addBitmapImage(c.x, c.y, c.w, c.h, c.image, WriteMode::ADD); });
+
+        // both paths have to draw the same pixels
+        display.clear();
+        check.clear();
+        perPixelBitmap(check, c.x, c.y, c.w, c.h, c.image, WriteMode::ADD);
+        display.addBitmapImage(c.x, c.y, c.w, c.h, c.image, WriteMode::ADD);
+        const bool same = memcmp(display.GetFrameBuffer().get(), check.GetFrameBuffer().get(), display.GetFrameBuffer().GetBufferSize()) == 0;
+
+        printf("  %-28s %8.2f us %8.2f us%s\n", c.name, perPixel, transpose, same ? "" : "  OUTPUT DIFFERS");
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+// fillRect: per pixel setPixel loop and a vspan per column against the page mask path
+#include "bench.h"
+#include "shapeRenderer/ShapeRenderer.h"
+#include "ssd1306.hpp"
+#include <cstring>
+
+using namespace pico_oled;
+
+// fillRect as first written: every pixel through setPixel
+static void perPixelFill(Canvas& canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, WriteMode mode)
+{
+    for (int16_t x = x0; x <= x1; x++)
+        for (int16_t y = y0; y <= y1; y++)
+            canvas.setPixel(x, y, mode);
+}
+
+// fillRect before page masks: one vertical span per column
+static void columnFill(Canvas& canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, WriteMode mode)
+{
+    for (int16_t x = x0; x <= x1; x++)
+        canvas.vspan(x, y0, y1, mode);
+}
+
+int main()
+{
+    i2c_inst i2c;
+    SSD1306 display(&i2c, 0x3C, Size::W128xH64);
+    SSD1306 check(&i2c, 0x3C, Size::W128xH64);
+    const size_t bufferSize = display.GetFrameBuffer().GetBufferSize();
+
+    struct Case {
+        const char* name;
+        int16_t x0, y0, x1, y1;
+        int runs;
+    };
+    const Case cases[] = {
+        { "full screen 128x64", 0, 0, 127, 63, 20000 },
+        { "unaligned 100x37 at 13,5", 13, 5, 112, 41, 20000 },
+        { "8x8 button", 50, 20, 57, 27, 200000 },
+    };
+
+    printf("fillRect, INVERT mode          setPixel      vspan   page masks\n");
+    for (const Case& c : cases) {
+        const double perPixel = measure(c.runs, [&] { perPixelFill(display, c.x0, c.y0, c.x1, c.y1, WriteMode::INVERT); });
+        const double column = measure(c.runs, [&] { columnFill(display, c.x0, c.y0, c.x1, c.y1, WriteMode::INVERT); });
+        const double pages = measure(c.runs, [&] { fillRect(&display, c.x0, c.y0, c.x1, c.y1, WriteMode::INVERT); });
+
+        // all three paths have to invert the same pixels
+        bool same = true;
+        check.clear();
+        perPixelFill(check, c.x0, c.y0, c.x1, c.y1, WriteMode::INVERT);
+        display.clear();
+        columnFill(display, c.x0, c.y0, c.x1, c.y1, WriteMode::INVERT);
+        same &= memcmp(display.GetFrameBuffer().get(), check.GetFrameBuffer().get(), bufferSize) == 0;
+        display.clear();
+        fillRect(&display, c.x0, c.y0, c.x1, c.y1, WriteMode::INVERT);
+        same &= memcmp(display.GetFrameBuffer().get(), check.GetFrameBuffer().get(), bufferSize) == 0;
+
+        printf("  %-26s %8.2f us %8.2f us %8.2f us%s\n", c.name, perPixel, column, pages, same ? "" : "  OUTPUT DIFFERS");
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Draws the sample screens rle_bench converts and writes them to assets/ as PBM images, lit pixels black
+#include "dither/Dither.h"
+#include "shapeRenderer/ShapeRenderer.h"
+#include "ssd1306.hpp"
+#include "textRenderer/16x32_font.h"
+#include "textRenderer/8x8_font.h"
+#include "textRenderer/TextRenderer.h"
+#include <cmath>
+#include <cstdio>
+
+using namespace pico_oled;
+
+static bool writePbm(const char* path, const Canvas& canvas, int16_t width, int16_t height)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+    fprintf(file, "P4\n%d %d\n", width, height);
+    for (int16_t y = 0; y < height; y++) {
+        for (int16_t x = 0; x < width; x += 8) {
+            uint8_t byte = 0;
+            for (int16_t bit = 0; bit < 8 && x + bit < width; bit++)
+                if (canvas.getPixel(x + bit, y))
+                    byte |= 0x80 >> bit;
+            fputc(byte, file);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+int main()
+{
+    i2c_inst i2c;
+    SSD1306 display(&i2c, 0x3C, Size::W128xH64);
+    bool ok = true;
+
+    // splash: frame around a big title
+    display.clear();
+    drawRect(&display, 0, 0, 127, 63);
+    drawRect(&display, 2, 2, 125, 61);
+    drawText(&display, font_16x32, "PICO", 32, 16);
+    ok &= writePbm("assets/splash.pbm", display, 128, 64);
+
+    // menu: eight lines of small text, the selected one inverted
+    const char* items[] = { "Display", "Brightness", "Contrast", "Sleep timer", "Sprites", "Fonts", "About", "Back" };
+    display.clear();
+    for (uint8_t i = 0; i < 8; i++)
+        drawText(&display, font_8x8, items[i], 4, i * 8);
+    fillRect(&display, 0, 16, 127, 23, WriteMode::INVERT);
+    ok &= writePbm("assets/menu.pbm", display, 128, 64);
+
+    // photo: lit sphere over a horizontal gradient, Floyd-Steinberg dithered
+    static uint8_t gray[128 * 64];
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 128; x++) {
+            const float dx = (x - 70) / 28.0f;
+            const float dy = (y - 32) / 28.0f;
+            const float d = dx * dx + dy * dy;
+            float value = x * 0.8f;
+            if (d < 1.0f)
+                value = 40.0f + 215.0f * std::sqrt(1.0f - d) * (0.6f - 0.4f * dx - 0.3f * dy);
+            gray[y * 128 + x] = static_cast<uint8_t>(std::fmin(std::fmax(value, 0.0f), 255.0f));
+        }
+    }
+    display.clear();
+    drawGrayImage(&display, 0, 0, 128, 64, gray);
+    ok &= writePbm("assets/photo.pbm", display, 128, 64);
+
+    // icon: 16x16 speaker
+    display.clear();
+    fillRect(&display, 1, 5, 4, 10);
+    const Point cone[] = { { 5, 5 }, { 9, 1 }, { 9, 14 }, { 5, 10 } };
+    fillPolygon(&display, cone, 4);
+    drawArc(&display, 9, 7, 4, -60, 60);
+    drawArc(&display, 9, 7, 6, -60, 60);
+    ok &= writePbm("assets/icon.pbm", display, 16, 16);
+
+    if (!ok)
+        fprintf(stderr, "couldn't write assets\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+// addSprite: raw against run length encoded sprites of typical screens, compression ratio and decode time
+#include "bench.h"
+#include "ssd1306.hpp"
+#include <cstring>
+
+#include "assets/icon_raw.h"
+#include "assets/icon_rle.h"
+#include "assets/menu_raw.h"
+#include "assets/menu_rle.h"
+#include "assets/photo_raw.h"
+#include "assets/photo_rle.h"
+#include "assets/splash_raw.h"
+#include "assets/splash_rle.h"
+
+using namespace pico_oled;
+
+int main()
+{
+    i2c_inst i2c;
+    SSD1306 display(&i2c, 0x3C, Size::W128xH64);
+    SSD1306 check(&i2c, 0x3C, Size::W128xH64);
+    const size_t bufferSize = display.GetFrameBuffer().GetBufferSize();
+
+    struct Case {
+        const char* name;
+        const uint8_t* raw;
+        size_t rawSize;
+        const uint8_t* rle;
+        size_t rleSize;
+    };
+    const Case cases[] = {
+        { "splash (frame + 16x32 text)", splash_raw, sizeof(splash_raw), splash_rle, sizeof(splash_rle) },
+        { "menu (8x8 text lines)", menu_raw, sizeof(menu_raw), menu_rle, sizeof(menu_rle) },
+        { "dithered photo", photo_raw, sizeof(photo_raw), photo_rle, sizeof(photo_rle) },
+        { "16x16 icon", icon_raw, sizeof(icon_raw), icon_rle, sizeof(icon_rle) },
+    };
+    const int runs = 20000;
+
+    printf("addSprite, COPY mode                 raw B   RLE B  ratio        raw        RLE\n");
+    for (const Case& c : cases) {
+        const double raw = measure(runs, [&] { display.addSprite(0, 0, c.raw, WriteMode::COPY); });
+        const double rle = measure(runs, [&] { display.addSprite(0, 0, c.rle, WriteMode::COPY); });
+
+        // decoded sprite has to match the raw one
+        display.clear();
+        check.clear();
+        display.addSprite(0, 0, c.rle, WriteMode::COPY);
+        check.addSprite(0, 0, c.raw, WriteMode::COPY);
+        const bool same = memcmp(display.GetFrameBuffer().get(), check.GetFrameBuffer().get(), bufferSize) == 0;
+
+        // sprite_convert.py keeps sprites raw when encoding wouldn't shrink them
+        const bool encoded = c.rle[2] & 0x02;
+        printf("  %-30s %7zu %7zu %5.1f%% %7.2f us %7.2f us%s%s\n", c.name, c.rawSize, c.rleSize, 100.0 * c.rleSize / c.rawSize, raw, rle,
+            encoded ? "" : "  kept raw", same ? "" : "  OUTPUT DIFFERS");
+    }
+    return 0;
+}
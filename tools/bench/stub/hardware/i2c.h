@@ -0,0 +1,19 @@
+// Host stand-in for the Pico SDK i2c header, only what the library uses. Writes succeed without going anywhere
+#ifndef BENCH_STUB_HARDWARE_I2C_H
+#define BENCH_STUB_HARDWARE_I2C_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct i2c_inst {
+};
+
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -2
+
+inline int i2c_write_timeout_us(i2c_inst*, uint8_t, const uint8_t*, size_t len, bool, unsigned)
+{
+    return static_cast<int>(len);
+}
+
+#endif // BENCH_STUB_HARDWARE_I2C_H
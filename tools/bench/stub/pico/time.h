@@ -0,0 +1,13 @@
+// Host stand-in for the Pico SDK time header, only what the library uses
+#ifndef BENCH_STUB_PICO_TIME_H
+#define BENCH_STUB_PICO_TIME_H
+
+#include <chrono>
+#include <cstdint>
+
+inline uint64_t time_us_64()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // BENCH_STUB_PICO_TIME_H
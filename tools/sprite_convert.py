@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+"""Converts PBM/PNG images to page-major sprite arrays for pico_oled.
+
+Sprite layout:
+    byte 0    - width in pixels
+    byte 1    - height in pixels
+    byte 2    - flags, bit 0 set when a transparency mask follows the image, bit 1 set when data is run length encoded
+    image     - width * ceil(height / 8) bytes, page after page, every byte holding 8 vertical pixels
+                of one column with the topmost in bit 0, same as display controller memory
+    mask      - optional, same layout as image, set bits mark opaque pixels
+
+With --rle every image page is followed by its mask page and the whole data is encoded in packets: control byte c
+below 0x80 is followed by c + 1 literal bytes, c from 0x80 up by one byte repeated c - 0x7E times.
+
+Dark pixels are lit on the display, pass --invert for light ones. PNG alpha below 128 is transparent
+and produces a mask. Only the python standard library is used.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+SPRITE_MASK = 0x01
+SPRITE_RLE = 0x02
+
+
+def read_pbm(data):
+    """Returns width, height and rows of 0/1 pixels, 1 being black"""
+    magic = data[:2]
+    if magic not in (b"P1", b"P4"):
+        raise ValueError("not a PBM file")
+    # header tokens, skipping comments
+    pos = 2
+    tokens = []
+    while len(tokens) < 2:
+        match = re.compile(rb"\s*(#[^\n]*\n\s*)*(\d+)").match(data, pos)
+        if not match:
+            raise ValueError("broken PBM header")
+        tokens.append(int(match.group(2)))
+        pos = match.end()
+    width, height = tokens
+    if magic == b"P1":
+        bits = [int(c) for c in re.findall(rb"[01]", data[pos:])]
+        return width, height, [bits[y * width:(y + 1) * width] for y in range(height)]
+    pos += 1  # single whitespace after header
+    stride = (width + 7) // 8
+    rows = []
+    for y in range(height):
+        row = data[pos + y * stride:pos + (y + 1) * stride]
+        rows.append([(row[x >> 3] >> (7 - (x & 7))) & 1 for x in range(width)])
+    return width, height, rows
+
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(data):
+    """Returns width, height, rows of luminance 0-255 and rows of alpha 0-255 (or None)"""
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("not a PNG file")
+    pos = 8
+    idat = b""
+    palette = []
+    trns = b""
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"PLTE":
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+        elif kind == b"tRNS":
+            trns = chunk
+        elif kind == b"IDAT":
+            idat += chunk
+        elif kind == b"IEND":
+            break
+    if interlace:
+        raise ValueError("interlaced PNG is not supported")
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color]
+    bits_per_pixel = channels * depth
+    stride = (width * bits_per_pixel + 7) // 8
+    step = max(1, bits_per_pixel // 8)
+    raw = zlib.decompress(idat)
+
+    # undo scanline filters
+    lines = []
+    prev = bytearray(stride)
+    for y in range(height):
+        kind = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - step] if i >= step else 0
+            b = prev[i]
+            c = prev[i - step] if i >= step else 0
+            if kind == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif kind == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif kind == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif kind == 4:
+                line[i] = (line[i] + _paeth(a, b, c)) & 0xFF
+        lines.append(line)
+        prev = line
+
+    # samples keep their full depth, so they can be compared with tRNS color keys
+    def samples(line):
+        if depth == 8:
+            return list(line)
+        if depth == 16:
+            return [(line[i] << 8) | line[i + 1] for i in range(0, len(line), 2)]
+        per_byte = 8 // depth
+        out = []
+        for byte in line:
+            for k in range(per_byte):
+                out.append((byte >> (8 - depth * (k + 1))) & ((1 << depth) - 1))
+        return out
+
+    def level(v):
+        """scales a sample to 0-255"""
+        if depth == 16:
+            return v >> 8
+        return v * (255 // ((1 << depth) - 1)) if depth < 8 else v
+
+    # color key of gray and RGB images, pixels matching it in full depth are transparent
+    key = None
+    if trns and color == 0:
+        key = struct.unpack(">H", trns[:2])
+    elif trns and color == 2:
+        key = struct.unpack(">HHH", trns[:6])
+
+    luma, alpha = [], []
+    has_alpha = color in (4, 6) or bool(trns)
+    for line in lines:
+        s = samples(line)
+        lrow, arow = [], []
+        for x in range(width):
+            px = s[x * channels:(x + 1) * channels]
+            a = 255
+            if color == 3:
+                r, g, b = palette[px[0]]
+                a = trns[px[0]] if px[0] < len(trns) else 255
+            else:
+                if color in (0, 4):
+                    r = g = b = level(px[0])
+                else:
+                    r, g, b = (level(v) for v in px[:3])
+                if color in (4, 6):
+                    a = level(px[-1])
+                elif key is not None and tuple(px) == key:
+                    a = 0
+            lrow.append((r * 299 + g * 587 + b * 114) // 1000)
+            arow.append(a)
+        luma.append(lrow)
+        alpha.append(arow)
+    return width, height, luma, alpha if has_alpha else None
+
+
+def load(path, invert):
+    """Returns width, height, rows of lit pixels and rows of opaque pixels (or None)"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:2] in (b"P1", b"P4"):
+        width, height, rows = read_pbm(data)
+        lit = [[bit ^ invert for bit in row] for row in rows]
+        return width, height, lit, None
+    width, height, luma, alpha = read_png(data)
+    lit = [[int(v < 128) ^ invert for v in row] for row in luma]
+    mask = [[int(a >= 128) for a in row] for row in alpha] if alpha else None
+    return width, height, lit, mask
+
+
+def to_pages(rows, width, height):
+    """Packs rows of pixels into page-major bytes"""
+    out = bytearray()
+    for page in range((height + 7) // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and rows[y][x]:
+                    byte |= 1 << bit
+            out.append(byte)
+    return out
+
+
+def rle_encode(data):
+    """Encodes bytes in literal and run packets, see module doc"""
+    out = bytearray()
+    literals = bytearray()
+
+    def flush_literals():
+        for i in range(0, len(literals), 128):
+            chunk = literals[i:i + 128]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+        literals.clear()
+
+    pos = 0
+    while pos < len(data):
+        run = 1
+        while pos + run < len(data) and run < 129 and data[pos + run] == data[pos]:
+            run += 1
+        # a pair of bytes is cheaper as a run only when it doesn't split literals
+        if run >= 3 or (run == 2 and not literals):
+            flush_literals()
+            out.append(0x7E + run)
+            out.append(data[pos])
+            pos += run
+        else:
+            literals.append(data[pos])
+            pos += 1
+    flush_literals()
+    return out
+
+
+def sprite_bytes(width, height, lit, mask, rle=False):
+    if not (0 < width < 256 and 0 < height < 256):
+        raise ValueError("sprites are limited to 255x255 pixels")
+    flags = SPRITE_MASK if mask else 0
+    image = to_pages(lit, width, height)
+    mask_pages = to_pages(mask, width, height) if mask else None
+    if rle:
+        # mask pages are interleaved so both can be decoded page by page from a single stream
+        stream = bytearray()
+        for page in range(0, len(image), width):
+            stream += image[page:page + width]
+            if mask_pages:
+                stream += mask_pages[page:page + width]
+        return bytearray([width, height, flags | SPRITE_RLE]) + rle_encode(stream)
+    data = bytearray([width, height, flags])
+    data += image
+    if mask_pages:
+        data += mask_pages
+    return data
+
+
+def header(name, width, height, data):
+    guard = "SPRITE_" + name.upper() + "_H"
+    lines = ["// generated by sprite_convert.py, do not edit",
+             "#ifndef " + guard,
+             "#define " + guard,
+             "",
+             "const unsigned char %s[] = {" % name,
+             "        0x%02X, 0x%02X, 0x%02X, // width, height, flags" % (data[0], data[1], data[2])]
+    body = data[3:]
+    for i in range(0, len(body), width):
+        chunk = body[i:i + width]
+        lines.append("        " + ", ".join("0x%02X" % b for b in chunk) + ",")
+    lines += ["};", "", "#endif // " + guard, ""]
+    return "\n".join(lines)
+
+
+def c_identifier(name):
+    """Turns name into a valid C identifier, ex. my-icon into my_icon and 2x into _2x"""
+    name = re.sub(r"\W", "_", name)
+    if not name or name[0].isdigit():
+        name = "_" + name
+    return name
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("image", help="PBM (P1/P4) or PNG image")
+    parser.add_argument("-o", "--output", help="header to write, stdout by default")
+    parser.add_argument("-n", "--name", help="array name, image file name by default. Made a valid C identifier")
+    parser.add_argument("--invert", action="store_true", help="light pixels are lit instead of dark ones")
+    parser.add_argument("--no-mask", action="store_true", help="ignore PNG transparency")
+    parser.add_argument("--rle", action="store_true", help="run length encode the sprite unless that makes it bigger")
+    args = parser.parse_args()
+
+    name = c_identifier(args.name or os.path.splitext(os.path.basename(args.image))[0])
+    width, height, lit, mask = load(args.image, int(args.invert))
+    if args.no_mask:
+        mask = None
+    data = sprite_bytes(width, height, lit, mask)
+    if args.rle:
+        encoded = sprite_bytes(width, height, lit, mask, rle=True)
+        if len(encoded) < len(data):
+            data = encoded
+        else:
+            sys.stderr.write("%s: encoding would not save space, kept uncompressed\n" % args.image)
+    text = header(name, width, height, data)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
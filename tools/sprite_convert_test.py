@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Checks of sprite_convert.py, run with `python3 sprite_convert_test.py`. Only the python standard library is used."""
+
+import struct
+import unittest
+import zlib
+
+import sprite_convert
+
+
+def png(width, height, depth, color, rows, trns=None):
+    """Builds an unfiltered PNG, rows being lists of samples of the given depth"""
+    def chunk(kind, data):
+        return struct.pack(">I", len(data)) + kind + data + struct.pack(">I", zlib.crc32(kind + data) & 0xFFFFFFFF)
+
+    raw = b""
+    for row in rows:
+        raw += b"\x00" + b"".join(struct.pack(">H" if depth == 16 else ">B", v) for v in row)
+    data = b"\x89PNG\r\n\x1a\n" + chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, depth, color, 0, 0, 0))
+    if trns is not None:
+        data += chunk(b"tRNS", trns)
+    return data + chunk(b"IDAT", zlib.compress(raw)) + chunk(b"IEND", b"")
+
+
+class ColorKeyTest(unittest.TestCase):
+    def test_rgb_key(self):
+        # left half magenta key, right half black
+        row = [255, 0, 255] * 4 + [0, 0, 0] * 4
+        _, _, luma, alpha = sprite_convert.read_png(png(8, 8, 8, 2, [row] * 8, struct.pack(">HHH", 255, 0, 255)))
+        self.assertEqual(alpha, [[0] * 4 + [255] * 4] * 8)
+        self.assertEqual(luma[0][4:], [0] * 4)
+
+    def test_rgb16_key(self):
+        row = [0xFFFF, 0, 0xFFFF] * 2 + [0xFF00, 0, 0xFFFF] * 2
+        _, _, _, alpha = sprite_convert.read_png(png(4, 2, 16, 2, [row] * 2, struct.pack(">HHH", 0xFFFF, 0, 0xFFFF)))
+        self.assertEqual(alpha, [[0, 0, 255, 255]] * 2)
+
+    def test_gray16_key(self):
+        # 0x8000 and 0x80FF share the high byte, only the first one is the key
+        row = [0x8000, 0x80FF, 0x0000, 0x8000]
+        _, _, luma, alpha = sprite_convert.read_png(png(4, 1, 16, 0, [row], struct.pack(">H", 0x8000)))
+        self.assertEqual(alpha, [[0, 255, 255, 0]])
+        self.assertEqual(luma, [[0x80, 0x80, 0, 0x80]])
+
+    def test_gray8_key(self):
+        _, _, _, alpha = sprite_convert.read_png(png(3, 1, 8, 0, [[7, 8, 7]], struct.pack(">H", 7)))
+        self.assertEqual(alpha, [[0, 255, 0]])
+
+    def test_mask_bytes(self):
+        # transparent key pixels end up cleared in the sprite mask
+        row = [255, 0, 255] * 4 + [0, 0, 0] * 4
+        data = png(8, 8, 8, 2, [row] * 8, struct.pack(">HHH", 255, 0, 255))
+        width, height, luma, alpha = sprite_convert.read_png(data)
+        lit = [[int(v < 128) for v in r] for r in luma]
+        mask = [[int(a >= 128) for a in r] for r in alpha]
+        sprite = sprite_convert.sprite_bytes(width, height, lit, mask)
+        self.assertEqual(sprite[2], 0x01)
+        self.assertEqual(list(sprite[3 + 8:]), [0x00] * 4 + [0xFF] * 4)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,40 @@
+set(PICO_OLED_SPRITE_CONVERTER ${CMAKE_CURRENT_LIST_DIR}/sprite_convert.py CACHE INTERNAL "")
+
+# pico_oled_add_sprites(<target> [INVERT] [RLE] IMAGES <image>...)
+# Converts PBM/PNG images to page-major sprite arrays at build time, see sprite_convert.py for the format.
+# Every image becomes sprites/<name>.h in the current binary dir, defining `const unsigned char <name>[]`
+# with <name> being the image file name without extension made a valid C identifier, ex. my-icon.png becomes my_icon
+# and 2x.png becomes _2x. The directory is added to target's include path.
+# RLE run length encodes sprites that get smaller that way.
+function(pico_oled_add_sprites target)
+    cmake_parse_arguments(SPRITES "INVERT;RLE" "" "IMAGES" ${ARGN})
+    find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+    set(options "")
+    if (SPRITES_INVERT)
+        list(APPEND options --invert)
+    endif ()
+    if (SPRITES_RLE)
+        list(APPEND options --rle)
+    endif ()
+
+    set(out_dir ${CMAKE_CURRENT_BINARY_DIR}/sprites)
+    set(headers "")
+    foreach (image ${SPRITES_IMAGES})
+        get_filename_component(name ${image} NAME_WE)
+        string(MAKE_C_IDENTIFIER "${name}" name)
+        get_filename_component(image_path ${image} ABSOLUTE)
+        set(header ${out_dir}/${name}.h)
+        add_custom_command(OUTPUT ${header}
+                COMMAND ${CMAKE_COMMAND} -E make_directory ${out_dir}
+                COMMAND Python3::Interpreter ${PICO_OLED_SPRITE_CONVERTER} ${image_path} -o ${header} -n ${name} ${options}
+                DEPENDS ${image_path} ${PICO_OLED_SPRITE_CONVERTER}
+                COMMENT "Converting sprite ${image}"
+                VERBATIM)
+        list(APPEND headers ${header})
+    endforeach ()
+
+    add_custom_target(${target}_sprites DEPENDS ${headers})
+    add_dependencies(${target} ${target}_sprites)
+    target_include_directories(${target} PRIVATE ${out_dir})
+endfunction()